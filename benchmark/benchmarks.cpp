@@ -0,0 +1,320 @@
+#include "circular-vector.h"
+#include "flat-map.h"
+#include "pool-allocator.h"
+#include "segmented-vector.h"
+#include "soa-vector.h"
+#include "vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+template <typename T>
+T make_value(size_t i) {
+  if constexpr (std::is_arithmetic_v<T>) {
+    return static_cast<T>(i);
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    // Long enough to not fit into the small string buffer
+    return std::string(32, static_cast<char>('a' + i % 26));
+  } else {
+    T result;
+    for (size_t j = 0; j < 4; ++j) {
+      result.push_back(static_cast<int>(i + j));
+    }
+    return result;
+  }
+}
+
+template <typename C>
+C make_container(size_t size) {
+  C result;
+  result.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    result.push_back(make_value<typename C::value_type>(i));
+  }
+  return result;
+}
+
+template <typename C>
+void push_back(benchmark::State& state) {
+  size_t size = state.range(0);
+  for (auto _ : state) {
+    C c;
+    for (size_t i = 0; i < size; ++i) {
+      c.push_back(make_value<typename C::value_type>(i));
+    }
+    benchmark::DoNotOptimize(&c.back());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename C>
+void push_back_reserved(benchmark::State& state) {
+  size_t size = state.range(0);
+  for (auto _ : state) {
+    C c;
+    c.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      c.push_back(make_value<typename C::value_type>(i));
+    }
+    benchmark::DoNotOptimize(c.data());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+// `unchecked_push_back` after `reserve`, `std::vector` has no such member and uses `push_back`
+template <typename C>
+void push_back_unchecked(benchmark::State& state) {
+  size_t size = state.range(0);
+  for (auto _ : state) {
+    C c;
+    c.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      if constexpr (requires { c.unchecked_push_back(make_value<typename C::value_type>(i)); }) {
+        c.unchecked_push_back(make_value<typename C::value_type>(i));
+      } else {
+        c.push_back(make_value<typename C::value_type>(i));
+      }
+    }
+    benchmark::DoNotOptimize(c.data());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Appends to many vectors from separate call sites, so that the time depends on how much code each of them
+// inlines. The vectors are reserved, the growth path never runs
+template <typename C>
+void push_back_many_call_sites(benchmark::State& state) {
+  size_t size = state.range(0);
+  std::array<C, 16> cs;
+  for (C& c : cs) {
+    c.reserve(size);
+  }
+  for (auto _ : state) {
+    for (C& c : cs) {
+      c.clear();
+    }
+    for (size_t i = 0; i < size; ++i) {
+      auto value = make_value<typename C::value_type>(i);
+      [&]<size_t... Is>(std::index_sequence<Is...>) {
+        (cs[Is].push_back(value), ...);
+      }(std::make_index_sequence<16>());
+    }
+    benchmark::DoNotOptimize(cs.data());
+  }
+  state.SetItemsProcessed(state.iterations() * size * cs.size());
+}
+
+template <typename C>
+void reserve_shrink_to_fit(benchmark::State& state) {
+  size_t size = state.range(0);
+  C c = make_container<C>(size);
+  for (auto _ : state) {
+    c.reserve(2 * size);
+    c.shrink_to_fit();
+    benchmark::DoNotOptimize(c.data());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+// `Position` is the insertion point as a fraction of the size: 0 is the beginning, 1 is the middle, 2 is the end
+template <typename C, size_t Position>
+void insert_erase(benchmark::State& state) {
+  size_t size = state.range(0);
+  C c = make_container<C>(size);
+  auto value = make_value<typename C::value_type>(size);
+  for (auto _ : state) {
+    auto pos = c.begin() + c.size() * Position / 2;
+    pos = c.insert(pos, value);
+    c.erase(pos);
+    benchmark::DoNotOptimize(c.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <typename C>
+void copy(benchmark::State& state) {
+  size_t size = state.range(0);
+  C c = make_container<C>(size);
+  for (auto _ : state) {
+    C copy = c;
+    benchmark::DoNotOptimize(copy.data());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename C>
+void move(benchmark::State& state) {
+  size_t size = state.range(0);
+  C c = make_container<C>(size);
+  for (auto _ : state) {
+    C other = std::move(c);
+    benchmark::DoNotOptimize(other.data());
+    c = std::move(other);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <typename C>
+void iterate(benchmark::State& state) {
+  size_t size = state.range(0);
+  C c = make_container<C>(size);
+  for (auto _ : state) {
+    for (auto& value : c) {
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+struct wide_record {
+  int key;
+  double values[7];
+};
+
+// Sums one field of a wide struct: `vector` reads whole records, `soa_vector` only the column of that field
+void scan_field_aos(benchmark::State& state) {
+  size_t size = state.range(0);
+  vector<wide_record> records;
+  for (size_t i = 0; i < size; ++i) {
+    records.push_back({static_cast<int>(i), {}});
+  }
+  for (auto _ : state) {
+    long long sum = 0;
+    for (const wide_record& record : records) {
+      sum += record.key;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+void scan_field_soa(benchmark::State& state) {
+  size_t size = state.range(0);
+  soa_vector<int, std::array<double, 7>> records;
+  for (size_t i = 0; i < size; ++i) {
+    records.push_back(static_cast<int>(i), {});
+  }
+  for (auto _ : state) {
+    long long sum = 0;
+    for (int key : records.column<0>()) {
+      sum += key;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Looks up a missing value, so the whole vector is scanned: with the vectorized `find` for `vector`, and
+// with `std::find` for `std::vector`
+template <typename C>
+void find_missing(benchmark::State& state) {
+  size_t size = state.range(0);
+  C c = make_container<C>(size);
+  for (auto _ : state) {
+    if constexpr (std::is_same_v<C, std::vector<int>>) {
+      benchmark::DoNotOptimize(std::find(c.begin(), c.end(), -1));
+    } else {
+      benchmark::DoNotOptimize(find(c, -1));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+// A FIFO queue that keeps `size` elements: `vector` erases its front by shifting the others, `circular_vector`
+// only advances its head
+template <typename C>
+void fifo(benchmark::State& state) {
+  size_t size = state.range(0);
+  C c;
+  for (size_t i = 0; i < size; ++i) {
+    c.push_back(static_cast<int>(i));
+  }
+  for (auto _ : state) {
+    c.push_back(c.front());
+    if constexpr (requires { c.pop_front(); }) {
+      c.pop_front();
+    } else {
+      c.erase(c.begin());
+    }
+    benchmark::DoNotOptimize(&c.back());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Looks up random present keys in a map built from `size` distinct keys
+template <typename Map>
+void map_lookup(benchmark::State& state) {
+  size_t size = state.range(0);
+  std::mt19937 gen(42);
+  std::vector<int> keys(size);
+  for (size_t i = 0; i < size; ++i) {
+    keys[i] = static_cast<int>(i * 7);
+  }
+  std::shuffle(keys.begin(), keys.end(), gen);
+  std::vector<std::pair<int, int>> elements;
+  for (int key : keys) {
+    elements.emplace_back(key, key);
+  }
+  Map map(elements.begin(), elements.end());
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(keys[i]));
+    i = i + 1 == size ? 0 : i + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+#define VECTOR_BENCHMARK(name, ...)                                                                            \
+  BENCHMARK_TEMPLATE(name, vector<__VA_ARGS__>)->Range(8, 8 << 10);                                          \
+  BENCHMARK_TEMPLATE(name, std::vector<__VA_ARGS__>)->Range(8, 8 << 10)
+
+#define VECTOR_BENCHMARK_POSITION(name, position, ...)                                                         \
+  BENCHMARK_TEMPLATE(name, vector<__VA_ARGS__>, position)->Range(8, 8 << 10);                                \
+  BENCHMARK_TEMPLATE(name, std::vector<__VA_ARGS__>, position)->Range(8, 8 << 10)
+
+#define VECTOR_BENCHMARKS(...)                                                                                 \
+  VECTOR_BENCHMARK(push_back, __VA_ARGS__);                                                                    \
+  VECTOR_BENCHMARK(push_back_reserved, __VA_ARGS__);                                                           \
+  VECTOR_BENCHMARK(push_back_unchecked, __VA_ARGS__);                                                          \
+  VECTOR_BENCHMARK(push_back_many_call_sites, __VA_ARGS__);                                                    \
+  VECTOR_BENCHMARK(reserve_shrink_to_fit, __VA_ARGS__);                                                        \
+  VECTOR_BENCHMARK_POSITION(insert_erase, 0, __VA_ARGS__);                                                     \
+  VECTOR_BENCHMARK_POSITION(insert_erase, 1, __VA_ARGS__);                                                     \
+  VECTOR_BENCHMARK_POSITION(insert_erase, 2, __VA_ARGS__);                                                     \
+  VECTOR_BENCHMARK(copy, __VA_ARGS__);                                                                         \
+  VECTOR_BENCHMARK(move, __VA_ARGS__);                                                                         \
+  VECTOR_BENCHMARK(iterate, __VA_ARGS__)
+
+VECTOR_BENCHMARKS(int);
+VECTOR_BENCHMARKS(std::string);
+VECTOR_BENCHMARKS(vector<int>);
+
+// Growth without relocation, compared with the results of `vector` above
+BENCHMARK_TEMPLATE(push_back, pooled_vector<int>)->Range(8, 8 << 10);
+BENCHMARK_TEMPLATE(push_back, pooled_vector<std::string>)->Range(8, 8 << 10);
+BENCHMARK_TEMPLATE(push_back, segmented_vector<int>)->Range(8, 8 << 10);
+BENCHMARK_TEMPLATE(push_back, segmented_vector<std::string>)->Range(8, 8 << 10);
+BENCHMARK_TEMPLATE(iterate, segmented_vector<int>)->Range(8, 8 << 10);
+
+BENCHMARK_TEMPLATE(find_missing, vector<int>)->Range(8, 8 << 16);
+BENCHMARK_TEMPLATE(find_missing, std::vector<int>)->Range(8, 8 << 16);
+
+BENCHMARK(scan_field_aos)->Range(8 << 10, 8 << 16);
+BENCHMARK(scan_field_soa)->Range(8 << 10, 8 << 16);
+
+BENCHMARK_TEMPLATE(map_lookup, flat_map<int, int>)->Range(8, 8 << 16);
+BENCHMARK_TEMPLATE(map_lookup, std::map<int, int>)->Range(8, 8 << 16);
+
+BENCHMARK_TEMPLATE(fifo, vector<int>)->Range(8, 8 << 10);
+BENCHMARK_TEMPLATE(fifo, circular_vector<int>)->Range(8, 8 << 10);
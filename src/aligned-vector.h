@@ -0,0 +1,50 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+// Allocates memory aligned to at least `Align` bytes (and to `alignof(T)`) with aligned `operator new`
+template <typename T, size_t Align>
+class aligned_allocator {
+  static_assert(Align != 0 && (Align & (Align - 1)) == 0, "alignment must be a power of two");
+
+public:
+  using value_type = T;
+  using is_always_equal = std::true_type;
+
+  static constexpr size_t alignment = Align < alignof(T) ? alignof(T) : Align;
+
+  template <typename U>
+  struct rebind {
+    using other = aligned_allocator<U, Align>;
+  };
+
+  aligned_allocator() = default;
+
+  template <typename U>
+  aligned_allocator(const aligned_allocator<U, Align>&) noexcept {}
+
+  T* allocate(size_t count) {
+    if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignment)));
+  }
+
+  void deallocate(T* ptr, size_t count) noexcept {
+    ::operator delete(ptr, count * sizeof(T), std::align_val_t(alignment));
+  }
+
+  template <typename U>
+  friend bool operator==(const aligned_allocator&, const aligned_allocator<U, Align>&) noexcept {
+    return true;
+  }
+};
+
+// `data()` is aligned to `Align` bytes, so it can be read with aligned SIMD loads
+template <typename T, size_t Align = 64>
+using aligned_vector = vector<T, aligned_allocator<T, Align>>;
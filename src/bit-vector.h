@@ -0,0 +1,306 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// Vector of bits packed into 64-bit words. Counting, searching and bitwise operations work a word at a time.
+// The bits of the last word past `size()` are always kept zero
+template <typename Allocator = std::allocator<uint64_t>>
+class bit_vector {
+  using word_type = uint64_t;
+  using words_type = vector<word_type, Allocator>;
+
+  static constexpr size_t word_bits = std::numeric_limits<word_type>::digits;
+  static constexpr word_type all_ones = ~word_type(0);
+
+public:
+  using value_type = bool;
+  using allocator_type = Allocator;
+
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+  // O(1) nothrow
+  bit_vector() noexcept(std::is_nothrow_default_constructible_v<Allocator>) = default;
+
+  // O(1) nothrow
+  explicit bit_vector(const Allocator& alloc) noexcept
+      : words_(alloc) {}
+
+  // O(N / 64) strong
+  explicit bit_vector(size_t count, bool value = false, const Allocator& alloc = Allocator())
+      : words_(alloc) {
+    resize(count, value);
+  }
+
+  // O(1) nothrow
+  allocator_type get_allocator() const noexcept {
+    return words_.get_allocator();
+  }
+
+  // O(1) nothrow
+  bool operator[](size_t index) const noexcept {
+    return test(index);
+  }
+
+  // O(1) nothrow
+  bool test(size_t index) const noexcept {
+    return (words_[index / word_bits] >> (index % word_bits)) & 1;
+  }
+
+  // O(1) nothrow
+  void set(size_t index, bool value = true) noexcept {
+    assign_masked(index / word_bits, word_type(1) << (index % word_bits), value);
+  }
+
+  // O(1) nothrow
+  void reset(size_t index) noexcept {
+    set(index, false);
+  }
+
+  // O(1) nothrow
+  void flip(size_t index) noexcept {
+    words_[index / word_bits] ^= word_type(1) << (index % word_bits);
+  }
+
+  // O((last - first) / 64) nothrow, sets the bits in `[first, last)` to `value`
+  void set_range(size_t first, size_t last, bool value = true) noexcept {
+    if (first == last) {
+      return;
+    }
+    size_t first_word = first / word_bits;
+    size_t last_word = (last - 1) / word_bits;
+    word_type first_mask = all_ones << (first % word_bits);
+    word_type last_mask = all_ones >> (word_bits - 1 - (last - 1) % word_bits);
+    if (first_word == last_word) {
+      assign_masked(first_word, first_mask & last_mask, value);
+      return;
+    }
+    assign_masked(first_word, first_mask, value);
+    std::fill(words_.begin() + first_word + 1, words_.begin() + last_word, value ? all_ones : 0);
+    assign_masked(last_word, last_mask, value);
+  }
+
+  // O((last - first) / 64) nothrow
+  void reset_range(size_t first, size_t last) noexcept {
+    set_range(first, last, false);
+  }
+
+  // O(N / 64) nothrow
+  void set_all(bool value = true) noexcept {
+    set_range(0, size_, value);
+  }
+
+  // O(N / 64) nothrow
+  void flip_all() noexcept {
+    for (word_type& word : words_) {
+      word = ~word;
+    }
+    clear_tail();
+  }
+
+  // O(1) nothrow
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  // O(1) nothrow
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  // O(1) nothrow
+  size_t capacity() const noexcept {
+    return words_.capacity() * word_bits;
+  }
+
+  // O(N / 64) strong
+  void reserve(size_t new_capacity) {
+    words_.reserve(word_count(new_capacity));
+  }
+
+  // O(N / 64) strong
+  void shrink_to_fit() {
+    words_.shrink_to_fit();
+  }
+
+  // O(1)* strong
+  void push_back(bool value) {
+    if (size_ % word_bits == 0) {
+      words_.push_back(0);
+    }
+    ++size_;
+    set(size_ - 1, value);
+  }
+
+  // O(1) nothrow
+  void pop_back() noexcept {
+    reset(--size_);
+    if (size_ % word_bits == 0) {
+      words_.pop_back();
+    }
+  }
+
+  // O(M / 64) strong
+  void resize(size_t count, bool value = false) {
+    size_t old_size = size_;
+    words_.resize(word_count(count), 0);
+    size_ = count;
+    if (count > old_size) {
+      set_range(old_size, count, value);
+    } else {
+      clear_tail();
+    }
+  }
+
+  // O(1) nothrow
+  void clear() noexcept {
+    words_.clear();
+    size_ = 0;
+  }
+
+  // O(1) nothrow
+  void swap(bit_vector& other) noexcept {
+    words_.swap(other.words_);
+    std::swap(size_, other.size_);
+  }
+
+  // O(1) nothrow
+  friend void swap(bit_vector& lhs, bit_vector& rhs) noexcept {
+    lhs.swap(rhs);
+  }
+
+  // O(N / 64) nothrow, the number of set bits
+  size_t count() const noexcept {
+    size_t result = 0;
+    for (word_type word : words_) {
+      result += std::popcount(word);
+    }
+    return result;
+  }
+
+  // O(N / 64) nothrow
+  bool any() const noexcept {
+    return find_first() != npos;
+  }
+
+  // O(N / 64) nothrow
+  bool none() const noexcept {
+    return !any();
+  }
+
+  // O(N / 64) nothrow
+  bool all() const noexcept {
+    return count() == size_;
+  }
+
+  // O(N / 64) nothrow, the index of the first set bit, or `npos`
+  size_t find_first() const noexcept {
+    return find_from_word(0);
+  }
+
+  // O(N / 64) nothrow, the index of the first set bit after `index`, or `npos`
+  size_t find_next(size_t index) const noexcept {
+    ++index;
+    if (index >= size_) {
+      return npos;
+    }
+    word_type word = words_[index / word_bits] & (all_ones << (index % word_bits));
+    if (word != 0) {
+      return index / word_bits * word_bits + std::countr_zero(word);
+    }
+    return find_from_word(index / word_bits + 1);
+  }
+
+  // O(N / 64) nothrow, the vectors must have the same size
+  bit_vector& operator&=(const bit_vector& other) noexcept {
+    for (size_t i = 0; i != words_.size(); ++i) {
+      words_[i] &= other.words_[i];
+    }
+    return *this;
+  }
+
+  // O(N / 64) nothrow, the vectors must have the same size
+  bit_vector& operator|=(const bit_vector& other) noexcept {
+    for (size_t i = 0; i != words_.size(); ++i) {
+      words_[i] |= other.words_[i];
+    }
+    return *this;
+  }
+
+  // O(N / 64) nothrow, the vectors must have the same size
+  bit_vector& operator^=(const bit_vector& other) noexcept {
+    for (size_t i = 0; i != words_.size(); ++i) {
+      words_[i] ^= other.words_[i];
+    }
+    return *this;
+  }
+
+  // O(N / 64) strong
+  friend bit_vector operator&(bit_vector lhs, const bit_vector& rhs) {
+    lhs &= rhs;
+    return lhs;
+  }
+
+  // O(N / 64) strong
+  friend bit_vector operator|(bit_vector lhs, const bit_vector& rhs) {
+    lhs |= rhs;
+    return lhs;
+  }
+
+  // O(N / 64) strong
+  friend bit_vector operator^(bit_vector lhs, const bit_vector& rhs) {
+    lhs ^= rhs;
+    return lhs;
+  }
+
+  // O(N / 64) nothrow
+  friend bool operator==(const bit_vector& lhs, const bit_vector& rhs) noexcept {
+    return lhs.size_ == rhs.size_ && std::equal(lhs.words_.begin(), lhs.words_.end(), rhs.words_.begin());
+  }
+
+  // O(1) nothrow, the packed bits, bit `i` is bit `i % 64` of word `i / 64`
+  std::span<const word_type> words() const noexcept {
+    return {words_.data(), words_.size()};
+  }
+
+private:
+  static constexpr size_t word_count(size_t bits) noexcept {
+    return bits / word_bits + (bits % word_bits != 0);
+  }
+
+  void assign_masked(size_t word, word_type mask, bool value) noexcept {
+    if (value) {
+      words_[word] |= mask;
+    } else {
+      words_[word] &= ~mask;
+    }
+  }
+
+  void clear_tail() noexcept {
+    if (size_ % word_bits != 0) {
+      words_.back() &= all_ones >> (word_bits - size_ % word_bits);
+    }
+  }
+
+  size_t find_from_word(size_t word) const noexcept {
+    for (; word < words_.size(); ++word) {
+      if (words_[word] != 0) {
+        return word * word_bits + std::countr_zero(words_[word]);
+      }
+    }
+    return npos;
+  }
+
+private:
+  words_type words_;
+  size_t size_ = 0;
+};
@@ -0,0 +1,524 @@
+#pragma once
+
+#include "growth-policy.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// Ring buffer with the interface of a double-ended vector: elements are added and removed at both ends in O(1)*
+// without shifting the others. The elements occupy at most two contiguous segments of the buffer, the one
+// from the first element to the end of the buffer and the one from its beginning; `linearize` makes them one.
+// Iterators refer to the vector itself and an index, they are invalidated by moving or swapping the vector
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = default_growth>
+class circular_vector {
+  using alloc_traits = std::allocator_traits<Allocator>;
+
+  static_assert(std::is_same_v<typename alloc_traits::value_type, T>, "Allocator::value_type must be T");
+  static_assert(std::is_same_v<typename alloc_traits::pointer, T*>, "Fancy pointers are not supported");
+
+  template <bool Const>
+  class basic_iterator {
+    using container = std::conditional_t<Const, const circular_vector, circular_vector>;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<Const, const T&, T&>;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+
+    basic_iterator() noexcept = default;
+
+    // O(1) nothrow
+    operator basic_iterator<true>() const noexcept {
+      return basic_iterator<true>(owner_, index_);
+    }
+
+    reference operator*() const noexcept {
+      return (*owner_)[index_];
+    }
+
+    pointer operator->() const noexcept {
+      return &**this;
+    }
+
+    reference operator[](difference_type n) const noexcept {
+      return (*owner_)[index_ + n];
+    }
+
+    basic_iterator& operator++() noexcept {
+      ++index_;
+      return *this;
+    }
+
+    basic_iterator operator++(int) noexcept {
+      basic_iterator result = *this;
+      ++*this;
+      return result;
+    }
+
+    basic_iterator& operator--() noexcept {
+      --index_;
+      return *this;
+    }
+
+    basic_iterator operator--(int) noexcept {
+      basic_iterator result = *this;
+      --*this;
+      return result;
+    }
+
+    basic_iterator& operator+=(difference_type n) noexcept {
+      index_ += n;
+      return *this;
+    }
+
+    basic_iterator& operator-=(difference_type n) noexcept {
+      index_ -= n;
+      return *this;
+    }
+
+    friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept {
+      return it += n;
+    }
+
+    friend basic_iterator operator+(difference_type n, basic_iterator it) noexcept {
+      return it += n;
+    }
+
+    friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept {
+      return it -= n;
+    }
+
+    friend difference_type operator-(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+      return static_cast<difference_type>(lhs.index_ - rhs.index_);
+    }
+
+    friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+      return lhs.index_ == rhs.index_;
+    }
+
+    friend std::strong_ordering operator<=>(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+      return lhs.index_ <=> rhs.index_;
+    }
+
+  private:
+    basic_iterator(container* owner, size_t index) noexcept
+        : owner_(owner)
+        , index_(index) {}
+
+    friend circular_vector;
+
+  private:
+    container* owner_ = nullptr;
+    size_t index_ = 0;
+  };
+
+public:
+  using value_type = T;
+  using allocator_type = Allocator;
+
+  using reference = T&;
+  using const_reference = const T&;
+
+  using pointer = T*;
+  using const_pointer = const T*;
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  // O(1) nothrow
+  circular_vector() noexcept(std::is_nothrow_default_constructible_v<Allocator>) = default;
+
+  // O(1) nothrow
+  explicit circular_vector(const Allocator& alloc) noexcept
+      : alloc_(alloc) {}
+
+  // O(N) strong
+  circular_vector(std::initializer_list<T> values, const Allocator& alloc = Allocator())
+      : circular_vector(alloc) {
+    reserve(values.size());
+    for (const T& value : values) {
+      emplace_back(value);
+    }
+  }
+
+  // O(N) strong
+  circular_vector(const circular_vector& other)
+      : circular_vector(other, alloc_traits::select_on_container_copy_construction(other.alloc_)) {}
+
+  // O(N) strong
+  circular_vector(const circular_vector& other, const Allocator& alloc)
+      : circular_vector(alloc) {
+    reserve(other.size_);
+    for (const T& value : other) {
+      emplace_back(value);
+    }
+  }
+
+  // O(1) nothrow
+  circular_vector(circular_vector&& other) noexcept
+      : alloc_(other.alloc_)
+      , data_(std::exchange(other.data_, nullptr))
+      , head_(std::exchange(other.head_, 0))
+      , size_(std::exchange(other.size_, 0))
+      , capacity_(std::exchange(other.capacity_, 0)) {}
+
+  // O(1) nothrow if allocators are equal, O(N) strong otherwise
+  circular_vector(circular_vector&& other, const Allocator& alloc)
+      : circular_vector(alloc) {
+    if (alloc_ == other.alloc_) {
+      steal(other);
+      return;
+    }
+    reserve(other.size_);
+    for (T& value : other) {
+      emplace_back(std::move(value));
+    }
+  }
+
+  // O(N) strong
+  circular_vector& operator=(const circular_vector& other) {
+    if (this != &other) {
+      constexpr bool propagate = alloc_traits::propagate_on_container_copy_assignment::value;
+      circular_vector copy(other, propagate ? other.alloc_ : alloc_);
+      release();
+      if constexpr (propagate) {
+        alloc_ = copy.alloc_;
+      }
+      steal(copy);
+    }
+    return *this;
+  }
+
+  // O(1) nothrow if allocators propagate or are equal, O(N) strong otherwise
+  circular_vector& operator=(circular_vector&& other) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value
+  ) {
+    if (this == &other) {
+      return *this;
+    }
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+      release();
+      alloc_ = std::move(other.alloc_);
+      steal(other);
+    } else if (alloc_traits::is_always_equal::value || alloc_ == other.alloc_) {
+      release();
+      steal(other);
+    } else {
+      circular_vector tmp(std::move(other), alloc_);
+      release();
+      steal(tmp);
+    }
+    return *this;
+  }
+
+  // O(N) nothrow
+  ~circular_vector() noexcept {
+    clear();
+    deallocate(data_, capacity_);
+  }
+
+  // O(1) nothrow
+  allocator_type get_allocator() const noexcept {
+    return alloc_;
+  }
+
+  // O(1) nothrow
+  reference operator[](size_t index) {
+    return data_[physical(index)];
+  }
+
+  // O(1) nothrow
+  const_reference operator[](size_t index) const {
+    return data_[physical(index)];
+  }
+
+  // O(1) nothrow
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  // O(1) nothrow
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  // O(1) nothrow
+  size_t capacity() const noexcept {
+    return capacity_;
+  }
+
+  // O(1) nothrow
+  reference front() {
+    return data_[head_];
+  }
+
+  // O(1) nothrow
+  const_reference front() const {
+    return data_[head_];
+  }
+
+  // O(1) nothrow
+  reference back() {
+    return (*this)[size_ - 1];
+  }
+
+  // O(1) nothrow
+  const_reference back() const {
+    return (*this)[size_ - 1];
+  }
+
+  // O(1)* strong
+  void push_back(const T& value) {
+    emplace_back(value);
+  }
+
+  // O(1)* strong
+  void push_back(T&& value) {
+    emplace_back(std::move(value));
+  }
+
+  // O(1)* strong
+  template <typename... Args>
+  reference emplace_back(Args&&... args) {
+    if (size_ == capacity_) {
+      return reallocate_with(size_, std::forward<Args>(args)...);
+    }
+    T* slot = data_ + physical(size_);
+    alloc_traits::construct(alloc_, slot, std::forward<Args>(args)...);
+    ++size_;
+    return *slot;
+  }
+
+  // O(1)* strong
+  void push_front(const T& value) {
+    emplace_front(value);
+  }
+
+  // O(1)* strong
+  void push_front(T&& value) {
+    emplace_front(std::move(value));
+  }
+
+  // O(1)* strong
+  template <typename... Args>
+  reference emplace_front(Args&&... args) {
+    if (size_ == capacity_) {
+      return reallocate_with(0, std::forward<Args>(args)...);
+    }
+    size_t new_head = head_ == 0 ? capacity_ - 1 : head_ - 1;
+    alloc_traits::construct(alloc_, data_ + new_head, std::forward<Args>(args)...);
+    head_ = new_head;
+    ++size_;
+    return data_[head_];
+  }
+
+  // O(1) nothrow
+  void pop_back() {
+    alloc_traits::destroy(alloc_, &back());
+    --size_;
+  }
+
+  // O(1) nothrow
+  void pop_front() {
+    alloc_traits::destroy(alloc_, data_ + head_);
+    head_ = head_ + 1 == capacity_ ? 0 : head_ + 1;
+    --size_;
+  }
+
+  // O(N) strong
+  void reserve(size_t new_capacity) {
+    if (new_capacity > capacity_) {
+      reallocate(new_capacity);
+    }
+  }
+
+  // O(N) strong
+  void shrink_to_fit() {
+    if (size_ != capacity_) {
+      reallocate(size_);
+    }
+  }
+
+  // O(N) nothrow, keeps the buffer
+  void clear() noexcept {
+    while (size_ != 0) {
+      pop_back();
+    }
+    head_ = 0;
+  }
+
+  // O(N) strong, moves the elements to one contiguous segment at the beginning of the buffer if they wrap around
+  std::span<T> linearize() {
+    if (head_ + size_ > capacity_) {
+      reallocate(capacity_);
+    }
+    return {data_ + head_, size_};
+  }
+
+  // O(1) nothrow, the allocators must be equal unless they propagate on swap
+  void swap(circular_vector& other) noexcept {
+    using std::swap;
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+      swap(alloc_, other.alloc_);
+    } else {
+      detail::check(alloc_ == other.alloc_, "swapping vectors with unequal allocators");
+    }
+    swap(data_, other.data_);
+    swap(head_, other.head_);
+    swap(size_, other.size_);
+    swap(capacity_, other.capacity_);
+  }
+
+  // O(1) nothrow
+  friend void swap(circular_vector& lhs, circular_vector& rhs) noexcept {
+    lhs.swap(rhs);
+  }
+
+  // O(1) nothrow
+  iterator begin() noexcept {
+    return iterator(this, 0);
+  }
+
+  // O(1) nothrow
+  iterator end() noexcept {
+    return iterator(this, size_);
+  }
+
+  // O(1) nothrow
+  const_iterator begin() const noexcept {
+    return const_iterator(this, 0);
+  }
+
+  // O(1) nothrow
+  const_iterator end() const noexcept {
+    return const_iterator(this, size_);
+  }
+
+private:
+  size_t physical(size_t index) const noexcept {
+    size_t result = head_ + index;
+    return result >= capacity_ ? result - capacity_ : result;
+  }
+
+  void deallocate(T* ptr, size_t count) noexcept {
+    if (ptr != nullptr) {
+      alloc_traits::deallocate(alloc_, ptr, count);
+    }
+  }
+
+  // Destroys the elements and frees the buffer
+  void release() noexcept {
+    clear();
+    deallocate(data_, capacity_);
+    data_ = nullptr;
+    capacity_ = 0;
+  }
+
+  // Takes the buffer of `other`, leaving it empty. `*this` must own no buffer, and its allocator must be equal to
+  // the one of `other`
+  void steal(circular_vector& other) noexcept {
+    data_ = std::exchange(other.data_, nullptr);
+    head_ = std::exchange(other.head_, 0);
+    size_ = std::exchange(other.size_, 0);
+    capacity_ = std::exchange(other.capacity_, 0);
+  }
+
+  // Copies the bytes of elements `[first, last)`, which occupy up to two segments of the buffer
+  void copy_bytes(size_t first, size_t last, T* dst) const noexcept {
+    size_t start = physical(first);
+    size_t count = std::min(last - first, capacity_ - start);
+    if (count != 0) {
+      std::memcpy(static_cast<void*>(dst), static_cast<const void*>(data_ + start), count * sizeof(T));
+    }
+    if (first + count != last) {
+      size_t rest = last - first - count;
+      std::memcpy(static_cast<void*>(dst + count), static_cast<const void*>(data_), rest * sizeof(T));
+    }
+  }
+
+  // Relocates the elements to the beginning of `new_data`, leaving a gap of `gap` elements before `index`.
+  // Elements are moved if that can't throw (or they can't be copied), and copied otherwise, so they are left
+  // intact on exception
+  void relocate_with_gap(T* new_data, size_t index, size_t gap) {
+    if constexpr (is_trivially_relocatable_v<T>) {
+      copy_bytes(0, index, new_data);
+      copy_bytes(index, size_, new_data + index + gap);
+    } else {
+      size_t i = 0;
+      try {
+        for (; i != size_; ++i) {
+          alloc_traits::construct(alloc_, new_data + i + (i < index ? 0 : gap), std::move_if_noexcept((*this)[i]));
+        }
+      } catch (...) {
+        while (i != 0) {
+          --i;
+          alloc_traits::destroy(alloc_, new_data + i + (i < index ? 0 : gap));
+        }
+        throw;
+      }
+      for (i = 0; i != size_; ++i) {
+        alloc_traits::destroy(alloc_, &(*this)[i]);
+      }
+    }
+  }
+
+  void reallocate(size_t new_capacity) {
+    T* new_data = new_capacity != 0 ? alloc_traits::allocate(alloc_, new_capacity) : nullptr;
+    try {
+      relocate_with_gap(new_data, size_, 0);
+    } catch (...) {
+      deallocate(new_data, new_capacity);
+      throw;
+    }
+    replace_buffer(new_data, new_capacity);
+  }
+
+  // The new element is constructed before the old ones are relocated, so `args` may refer to an element of `*this`
+  template <typename... Args>
+  reference reallocate_with(size_t index, Args&&... args) {
+    size_t new_capacity = std::max(size_ + 1, GrowthPolicy::grow(capacity_, size_ + 1, sizeof(T)));
+    T* new_data = alloc_traits::allocate(alloc_, new_capacity);
+    try {
+      alloc_traits::construct(alloc_, new_data + index, std::forward<Args>(args)...);
+    } catch (...) {
+      deallocate(new_data, new_capacity);
+      throw;
+    }
+    try {
+      relocate_with_gap(new_data, index, 1);
+    } catch (...) {
+      alloc_traits::destroy(alloc_, new_data + index);
+      deallocate(new_data, new_capacity);
+      throw;
+    }
+    replace_buffer(new_data, new_capacity);
+    ++size_;
+    return data_[index];
+  }
+
+  // Old elements must have been already relocated to the beginning of `new_data`
+  void replace_buffer(T* new_data, size_t new_capacity) noexcept {
+    deallocate(data_, capacity_);
+    data_ = new_data;
+    head_ = 0;
+    capacity_ = new_capacity;
+  }
+
+private:
+  [[no_unique_address]] Allocator alloc_;
+  T* data_ = nullptr;
+  size_t head_ = 0;
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+};
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "segment-layout.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Vector that many threads can append to concurrently. A slot is claimed with a single `fetch_add` on the size,
+// and the storage is a list of segments of growing powers of two, so existing elements are never moved and
+// references to them stay valid until `clear` or destruction.
+// An element may be read by another thread once its insertion happens-before the read; `for_each` only visits
+// elements whose construction has finished, so it may run concurrently with insertions. If constructing an
+// element throws, its slot stays empty: it is counted by `size()`, but skipped by `for_each`
+template <typename T, typename Allocator = std::allocator<T>>
+class concurrent_vector {
+  struct slot {
+    alignas(T) std::byte storage[sizeof(T)];
+    std::atomic<bool> ready = false;
+
+    T* get() noexcept {
+      return std::launder(reinterpret_cast<T*>(storage));
+    }
+
+    const T* get() const noexcept {
+      return std::launder(reinterpret_cast<const T*>(storage));
+    }
+  };
+
+  using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<slot>;
+  using slot_traits = std::allocator_traits<slot_allocator>;
+  using alloc_traits = std::allocator_traits<Allocator>;
+
+  using layout = detail::segment_layout;
+
+public:
+  using value_type = T;
+  using allocator_type = Allocator;
+
+  using reference = T&;
+  using const_reference = const T&;
+
+  // O(1) nothrow
+  concurrent_vector() noexcept(std::is_nothrow_default_constructible_v<Allocator>) = default;
+
+  // O(1) nothrow
+  explicit concurrent_vector(const Allocator& alloc) noexcept
+      : alloc_(alloc) {}
+
+  concurrent_vector(const concurrent_vector&) = delete;
+  concurrent_vector& operator=(const concurrent_vector&) = delete;
+
+  // O(N) nothrow
+  ~concurrent_vector() noexcept {
+    clear();
+    slot_allocator alloc(alloc_);
+    for (size_t segment = 0; segment != layout::max_segment_count; ++segment) {
+      slot* slots = segments_[segment].load(std::memory_order_relaxed);
+      if (slots != nullptr) {
+        slot_traits::deallocate(alloc, slots, layout::segment_size(segment));
+      }
+    }
+  }
+
+  // O(1) nothrow
+  allocator_type get_allocator() const noexcept {
+    return alloc_;
+  }
+
+  // O(1) nothrow, the element must have been constructed
+  T& operator[](size_t index) {
+    return *find_slot(index).get();
+  }
+
+  // O(1) nothrow
+  const T& operator[](size_t index) const {
+    return *find_slot(index).get();
+  }
+
+  // O(1) nothrow, the number of claimed slots, including the ones whose elements are being constructed
+  size_t size() const noexcept {
+    // Insertions that fail on `max_size()` claim a slot for a moment before giving it back
+    return std::min(size_.load(std::memory_order_acquire), max_size());
+  }
+
+  // O(1) nothrow
+  static constexpr size_t max_size() noexcept {
+    return layout::max_size();
+  }
+
+  // O(1) nothrow
+  bool empty() const noexcept {
+    return size() == 0;
+  }
+
+  // O(1) nothrow, may be called concurrently with insertions
+  bool is_constructed(size_t index) const noexcept {
+    if (index >= size()) {
+      return false;
+    }
+    slot* slots = segments_[layout::segment_of(index)].load(std::memory_order_acquire);
+    return slots != nullptr && slots[layout::offset_of(index)].ready.load(std::memory_order_acquire);
+  }
+
+  // O(1) strong (the slot stays empty on exception), lock-free unless a new segment is allocated
+  T& push_back(const T& value) {
+    return emplace_back(value);
+  }
+
+  // O(1) strong (the slot stays empty on exception), lock-free unless a new segment is allocated
+  T& push_back(T&& value) {
+    return emplace_back(std::move(value));
+  }
+
+  // O(1) strong (the slot stays empty on exception), lock-free unless a new segment is allocated
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    size_t index = size_.fetch_add(1, std::memory_order_acq_rel);
+    if (index >= max_size()) {
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      throw std::length_error("concurrent_vector: max_size() exceeded");
+    }
+    slot& s = segment(layout::segment_of(index))[layout::offset_of(index)];
+    alloc_traits::construct(alloc_, reinterpret_cast<T*>(s.storage), std::forward<Args>(args)...);
+    s.ready.store(true, std::memory_order_release);
+    return *s.get();
+  }
+
+  // O(N) strong, allocates the segments for the first `count` elements. May be called concurrently with insertions
+  void reserve(size_t count) {
+    for (size_t segment = 0; layout::segment_begin(segment) < count; ++segment) {
+      this->segment(segment);
+    }
+  }
+
+  // O(N), calls `f` for the constructed elements in order. May be called concurrently with insertions
+  template <typename F>
+  void for_each(F&& f) const {
+    size_t count = size();
+    for (size_t segment = 0; layout::segment_begin(segment) < count; ++segment) {
+      slot* slots = segments_[segment].load(std::memory_order_acquire);
+      if (slots == nullptr) {
+        continue;
+      }
+      size_t end = std::min(layout::segment_size(segment), count - layout::segment_begin(segment));
+      for (size_t i = 0; i != end; ++i) {
+        if (slots[i].ready.load(std::memory_order_acquire)) {
+          f(std::as_const(*slots[i].get()));
+        }
+      }
+    }
+  }
+
+  // O(N) nothrow, keeps the segments. Must not be called concurrently with other operations
+  void clear() noexcept {
+    size_t count = size();
+    for (size_t index = count; index-- != 0;) {
+      slot* slots = segments_[layout::segment_of(index)].load(std::memory_order_relaxed);
+      if (slots != nullptr && slots[layout::offset_of(index)].ready.load(std::memory_order_relaxed)) {
+        slots[layout::offset_of(index)].ready.store(false, std::memory_order_relaxed);
+        alloc_traits::destroy(alloc_, slots[layout::offset_of(index)].get());
+      }
+    }
+    size_.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  slot& find_slot(size_t index) const noexcept {
+    return segments_[layout::segment_of(index)].load(std::memory_order_acquire)[layout::offset_of(index)];
+  }
+
+  // Returns the segment, allocating it if needed. Threads that race to allocate it keep the first allocation
+  slot* segment(size_t segment) {
+    slot* slots = segments_[segment].load(std::memory_order_acquire);
+    if (slots != nullptr) {
+      return slots;
+    }
+    slot_allocator alloc(alloc_);
+    size_t size = layout::segment_size(segment);
+    slot* new_slots = slot_traits::allocate(alloc, size);
+    for (size_t i = 0; i != size; ++i) {
+      ::new (static_cast<void*>(new_slots + i)) slot();
+    }
+    if (segments_[segment].compare_exchange_strong(slots, new_slots, std::memory_order_acq_rel)) {
+      return new_slots;
+    }
+    slot_traits::deallocate(alloc, new_slots, size);
+    return slots;
+  }
+
+private:
+  [[no_unique_address]] Allocator alloc_;
+  std::atomic<size_t> size_ = 0;
+  std::array<std::atomic<slot*>, layout::max_segment_count> segments_{};
+};
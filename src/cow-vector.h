@@ -0,0 +1,308 @@
+#pragma once
+
+#include "vector.h"
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+
+// Vector whose copies share the elements until one of them is modified, so copying is O(1). Modifying a vector
+// that shares its elements first copies them (once, in O(N)), after which it owns them exclusively.
+// Copying and destroying vectors that share elements is safe from different threads, modifying one vector from
+// several threads requires synchronization as usual
+template <typename T, typename Allocator = std::allocator<T>>
+class cow_vector {
+  using items_type = vector<T, Allocator>;
+
+  struct shared_state {
+    template <typename... Args>
+    explicit shared_state(Args&&... args)
+        : items(std::forward<Args>(args)...) {}
+
+    std::atomic<size_t> refs = 1;
+    items_type items;
+  };
+
+  using alloc_traits = std::allocator_traits<Allocator>;
+  using state_allocator = typename alloc_traits::template rebind_alloc<shared_state>;
+  using state_traits = std::allocator_traits<state_allocator>;
+
+public:
+  using value_type = T;
+  using allocator_type = Allocator;
+
+  using reference = T&;
+  using const_reference = const T&;
+
+  using pointer = T*;
+  using const_pointer = const T*;
+
+  using iterator = pointer;
+  using const_iterator = const_pointer;
+
+  // O(1) nothrow
+  cow_vector() noexcept(std::is_nothrow_default_constructible_v<Allocator>) = default;
+
+  // O(1) nothrow
+  explicit cow_vector(const Allocator& alloc) noexcept
+      : alloc_(alloc) {}
+
+  // O(1) strong
+  explicit cow_vector(items_type items)
+      : alloc_(items.get_allocator())
+      , state_(make_state(std::move(items))) {}
+
+  // O(N) strong
+  cow_vector(std::initializer_list<T> values, const Allocator& alloc = Allocator())
+      : alloc_(alloc) {
+    items_type items(alloc_);
+    items.assign(values);
+    state_ = make_state(std::move(items));
+  }
+
+  // O(1) nothrow
+  cow_vector(const cow_vector& other) noexcept
+      : alloc_(other.alloc_)
+      , state_(other.state_) {
+    if (state_ != nullptr) {
+      state_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  // O(1) nothrow
+  cow_vector(cow_vector&& other) noexcept
+      : alloc_(other.alloc_)
+      , state_(std::exchange(other.state_, nullptr)) {}
+
+  // O(1) nothrow if allocators propagate or are equal, O(N) strong otherwise. O(N) nothrow if this was the last
+  // owner of its elements
+  cow_vector& operator=(const cow_vector& other) {
+    if (this == &other) {
+      return *this;
+    }
+    if (alloc_traits::propagate_on_container_copy_assignment::value || alloc_ == other.alloc_) {
+      share(other);
+    } else {
+      replace_state(copy_state(other.items()));
+    }
+    return *this;
+  }
+
+  // O(1) nothrow if allocators propagate or are equal, O(N) strong otherwise. O(N) nothrow if this was the last
+  // owner of its elements
+  cow_vector& operator=(cow_vector&& other) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value
+  ) {
+    if (this == &other) {
+      return *this;
+    }
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+      release();
+      alloc_ = std::move(other.alloc_);
+      state_ = std::exchange(other.state_, nullptr);
+    } else if (alloc_traits::is_always_equal::value || alloc_ == other.alloc_) {
+      release();
+      state_ = std::exchange(other.state_, nullptr);
+    } else if (other.is_shared()) {
+      replace_state(copy_state(other.items()));
+    } else {
+      replace_state(copy_state(std::move(other.state_->items)));
+    }
+    return *this;
+  }
+
+  // O(1) nothrow, O(N) nothrow if this is the last owner of its elements
+  ~cow_vector() noexcept {
+    release();
+  }
+
+  // O(1) nothrow, the allocators must be equal unless they propagate on swap
+  void swap(cow_vector& other) noexcept {
+    using std::swap;
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+      swap(alloc_, other.alloc_);
+    } else {
+      detail::check(alloc_ == other.alloc_, "swapping vectors with unequal allocators");
+    }
+    swap(state_, other.state_);
+  }
+
+  // O(1) nothrow
+  friend void swap(cow_vector& lhs, cow_vector& rhs) noexcept {
+    lhs.swap(rhs);
+  }
+
+  // O(1) nothrow
+  allocator_type get_allocator() const noexcept {
+    return alloc_;
+  }
+
+  // O(1) nothrow
+  const T& operator[](size_t index) const {
+    return data()[index];
+  }
+
+  // O(1) nothrow
+  const T* data() const noexcept {
+    return state_ != nullptr ? state_->items.data() : nullptr;
+  }
+
+  // O(1) nothrow
+  size_t size() const noexcept {
+    return state_ != nullptr ? state_->items.size() : 0;
+  }
+
+  // O(1) nothrow
+  bool empty() const noexcept {
+    return size() == 0;
+  }
+
+  // O(1) nothrow
+  const T& front() const {
+    return data()[0];
+  }
+
+  // O(1) nothrow
+  const T& back() const {
+    return data()[size() - 1];
+  }
+
+  // O(1) nothrow
+  const_iterator begin() const noexcept {
+    return data();
+  }
+
+  // O(1) nothrow
+  const_iterator end() const noexcept {
+    return data() + size();
+  }
+
+  // O(1) nothrow
+  const items_type& items() const noexcept {
+    return state_ != nullptr ? state_->items : empty_items();
+  }
+
+  // O(1) nothrow, whether the elements are shared with another vector
+  bool is_shared() const noexcept {
+    return state_ != nullptr && state_->refs.load(std::memory_order_acquire) != 1;
+  }
+
+  // O(1) strong, O(N) strong if the elements are shared. Gives access to the elements for modification,
+  // the reference is valid until this vector is copied, assigned or destroyed
+  items_type& mutate() {
+    return mutate(0);
+  }
+
+  // O(1)* strong, O(N) strong if the elements are shared
+  void push_back(const T& value) {
+    if (is_shared()) {
+      // `value` may be an element that is about to stop being shared
+      T copy = value;
+      mutate(1).push_back(std::move(copy));
+    } else {
+      mutate(1).push_back(value);
+    }
+  }
+
+  // O(1)* strong, O(N) strong if the elements are shared
+  void push_back(T&& value) {
+    mutate(1).push_back(std::move(value));
+  }
+
+  // O(1)* strong, O(N) strong if the elements are shared
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    if (is_shared()) {
+      T value(std::forward<Args>(args)...);
+      return mutate(1).emplace_back(std::move(value));
+    }
+    return mutate(1).emplace_back(std::forward<Args>(args)...);
+  }
+
+  // O(1) nothrow, O(N) strong if the elements are shared
+  void pop_back() {
+    mutate().pop_back();
+  }
+
+  // O(1) nothrow if the elements are shared, O(N) nothrow otherwise
+  void clear() noexcept {
+    if (is_shared()) {
+      release();
+      state_ = nullptr;
+    } else if (state_ != nullptr) {
+      state_->items.clear();
+    }
+  }
+
+private:
+  // Copies shared elements leaving room for `extra` more, so that the following insertion doesn't reallocate
+  items_type& mutate(size_t extra) {
+    if (state_ == nullptr) {
+      state_ = make_state(alloc_);
+    } else if (is_shared()) {
+      items_type copy(alloc_);
+      copy.reserve(state_->items.size() + extra);
+      copy.append_range(state_->items);
+      replace_state(make_state(std::move(copy)));
+    }
+    return state_->items;
+  }
+
+  template <typename... Args>
+  shared_state* make_state(Args&&... args) {
+    state_allocator alloc(alloc_);
+    shared_state* state = state_traits::allocate(alloc, 1);
+    try {
+      state_traits::construct(alloc, state, std::forward<Args>(args)...);
+    } catch (...) {
+      state_traits::deallocate(alloc, state, 1);
+      throw;
+    }
+    return state;
+  }
+
+  // New state with the elements of `items` in an allocator equal to `alloc_`
+  template <typename Items>
+  shared_state* copy_state(Items&& items) {
+    return make_state(items_type(std::forward<Items>(items), alloc_));
+  }
+
+  // Shares the elements of `other`, taking its allocator if it propagates on copy assignment. Otherwise the
+  // allocators must be equal, so that the last owner releases the elements with an allocator equal to the one
+  // that allocated them
+  void share(const cow_vector& other) noexcept {
+    if (other.state_ != nullptr) {
+      other.state_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    release();
+    if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+      alloc_ = other.alloc_;
+    }
+    state_ = other.state_;
+  }
+
+  // `state` must be allocated with an allocator equal to `alloc_`
+  void replace_state(shared_state* state) noexcept {
+    release();
+    state_ = state;
+  }
+
+  void release() noexcept {
+    if (state_ != nullptr && state_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      state_allocator alloc(alloc_);
+      state_traits::destroy(alloc, state_);
+      state_traits::deallocate(alloc, state_, 1);
+    }
+  }
+
+  static const items_type& empty_items() noexcept {
+    static const items_type empty;
+    return empty;
+  }
+
+private:
+  [[no_unique_address]] Allocator alloc_;
+  shared_state* state_ = nullptr;
+};
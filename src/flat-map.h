@@ -0,0 +1,448 @@
+#pragma once
+
+#include "flat-set.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Map that stores its keys sorted in one contiguous container and the values in another, like `std::flat_map`.
+// Lookups are binary searches over the keys only, insertions and erasures shift the elements after the position.
+// Iterators yield pairs of references `std::pair<const Key&, T&>`, rather than references to pairs
+template <typename Key, typename T, typename Compare = std::less<Key>, typename KeyContainer = vector<Key>,
+          typename MappedContainer = vector<T>>
+class flat_map {
+  template <bool Const>
+  class basic_iterator {
+    using container = std::conditional_t<Const, const flat_map, flat_map>;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::pair<Key, T>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<Const, std::pair<const Key&, const T&>, std::pair<const Key&, T&>>;
+    using pointer = void;
+
+    basic_iterator() noexcept = default;
+
+    // O(1) nothrow
+    operator basic_iterator<true>() const noexcept {
+      return basic_iterator<true>(owner_, index_);
+    }
+
+    reference operator*() const noexcept {
+      return {owner_->keys_[index_], owner_->values_[index_]};
+    }
+
+    reference operator[](difference_type n) const noexcept {
+      return *(*this + n);
+    }
+
+    basic_iterator& operator++() noexcept {
+      ++index_;
+      return *this;
+    }
+
+    basic_iterator operator++(int) noexcept {
+      basic_iterator result = *this;
+      ++*this;
+      return result;
+    }
+
+    basic_iterator& operator--() noexcept {
+      --index_;
+      return *this;
+    }
+
+    basic_iterator operator--(int) noexcept {
+      basic_iterator result = *this;
+      --*this;
+      return result;
+    }
+
+    basic_iterator& operator+=(difference_type n) noexcept {
+      index_ += n;
+      return *this;
+    }
+
+    basic_iterator& operator-=(difference_type n) noexcept {
+      index_ -= n;
+      return *this;
+    }
+
+    friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept {
+      return it += n;
+    }
+
+    friend basic_iterator operator+(difference_type n, basic_iterator it) noexcept {
+      return it += n;
+    }
+
+    friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept {
+      return it -= n;
+    }
+
+    friend difference_type operator-(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+      return static_cast<difference_type>(lhs.index_ - rhs.index_);
+    }
+
+    friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+      return lhs.index_ == rhs.index_;
+    }
+
+    friend std::strong_ordering operator<=>(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+      return lhs.index_ <=> rhs.index_;
+    }
+
+  private:
+    basic_iterator(container* owner, size_t index) noexcept
+        : owner_(owner)
+        , index_(index) {}
+
+    friend flat_map;
+
+  private:
+    container* owner_ = nullptr;
+    size_t index_ = 0;
+  };
+
+public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key, T>;
+  using key_compare = Compare;
+  using key_container_type = KeyContainer;
+  using mapped_container_type = MappedContainer;
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  // O(1) nothrow
+  flat_map() = default;
+
+  // O(1) nothrow
+  explicit flat_map(const Compare& comp)
+      : comp_(comp) {}
+
+  // O(N log N) strong, `keys` and `values` must have the same size. Keeps the first of equivalent keys
+  flat_map(KeyContainer keys, MappedContainer values, const Compare& comp = Compare())
+      : comp_(comp) {
+    merge_sorted(sort_unique(std::move(keys), std::move(values)));
+  }
+
+  // O(N log N) strong, keeps the first of equivalent keys
+  template <std::input_iterator InputIt>
+  flat_map(InputIt first, InputIt last, const Compare& comp = Compare())
+      : comp_(comp) {
+    insert(first, last);
+  }
+
+  // O(N log N) strong
+  flat_map(std::initializer_list<value_type> values, const Compare& comp = Compare())
+      : flat_map(values.begin(), values.end(), comp) {}
+
+  // O(1) nothrow
+  iterator begin() noexcept {
+    return iterator(this, 0);
+  }
+
+  // O(1) nothrow
+  iterator end() noexcept {
+    return iterator(this, size());
+  }
+
+  // O(1) nothrow
+  const_iterator begin() const noexcept {
+    return const_iterator(this, 0);
+  }
+
+  // O(1) nothrow
+  const_iterator end() const noexcept {
+    return const_iterator(this, size());
+  }
+
+  // O(1) nothrow
+  size_t size() const noexcept {
+    return keys_.size();
+  }
+
+  // O(1) nothrow
+  bool empty() const noexcept {
+    return keys_.empty();
+  }
+
+  // O(N) strong
+  void reserve(size_t new_capacity) {
+    keys_.reserve(new_capacity);
+    values_.reserve(new_capacity);
+  }
+
+  // O(N) nothrow
+  void clear() noexcept {
+    keys_.clear();
+    values_.clear();
+  }
+
+  // O(1) nothrow
+  const KeyContainer& keys() const noexcept {
+    return keys_;
+  }
+
+  // O(1) nothrow
+  const MappedContainer& values() const noexcept {
+    return values_;
+  }
+
+  // O(1) nothrow
+  key_compare key_comp() const {
+    return comp_;
+  }
+
+  // O(log N), O(N) strong if the key is inserted
+  T& operator[](const Key& key)
+    requires std::default_initializable<T>
+  {
+    return (*try_emplace(key).first).second;
+  }
+
+  // O(log N)
+  T& at(const Key& key) {
+    size_t index = find_index(key);
+    if (index == size()) {
+      throw std::out_of_range("flat_map::at");
+    }
+    return values_[index];
+  }
+
+  // O(log N)
+  const T& at(const Key& key) const {
+    size_t index = find_index(key);
+    if (index == size()) {
+      throw std::out_of_range("flat_map::at");
+    }
+    return values_[index];
+  }
+
+  // O(N) strong if moving doesn't throw, basic otherwise
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return try_emplace(value.first, value.second);
+  }
+
+  // O(N) strong if moving doesn't throw, basic otherwise
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return try_emplace(std::move(value.first), std::move(value.second));
+  }
+
+  // O(N) strong if moving doesn't throw, basic otherwise. The value is constructed only if the key is inserted
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    return emplace_key(key, std::forward<Args>(args)...);
+  }
+
+  // O(N) strong if moving doesn't throw, basic otherwise
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+    return emplace_key(std::move(key), std::forward<Args>(args)...);
+  }
+
+  // O(N) strong if moving doesn't throw, basic otherwise
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const Key& key, M&& value) {
+    std::pair<iterator, bool> result = try_emplace(key, std::forward<M>(value));
+    if (!result.second) {
+      values_[result.first.index_] = std::forward<M>(value);
+    }
+    return result;
+  }
+
+  // O(N + M log M) strong if the comparison doesn't throw, basic otherwise. The new elements are sorted and
+  // merged with the old ones in a single pass, keeping the existing values of equal keys
+  template <std::input_iterator InputIt>
+  void insert(InputIt first, InputIt last) {
+    KeyContainer keys;
+    MappedContainer values;
+    for (; first != last; ++first) {
+      const auto& [key, value] = *first;
+      keys.push_back(key);
+      values.push_back(value);
+    }
+    merge_sorted(sort_unique(std::move(keys), std::move(values)));
+  }
+
+  // O(N + M log M) strong if the comparison doesn't throw, basic otherwise
+  void insert(std::initializer_list<value_type> values) {
+    insert(values.begin(), values.end());
+  }
+
+  // O(N) nothrow(move)
+  iterator erase(const_iterator pos) {
+    keys_.erase(keys_.begin() + pos.index_);
+    values_.erase(values_.begin() + pos.index_);
+    return begin() + pos.index_;
+  }
+
+  // O(N) nothrow(move), returns the number of erased elements
+  size_t erase(const Key& key) {
+    size_t index = find_index(key);
+    if (index == size()) {
+      return 0;
+    }
+    erase(begin() + index);
+    return 1;
+  }
+
+  // O(log N)
+  iterator find(const Key& key) {
+    return begin() + find_index(key);
+  }
+
+  // O(log N)
+  const_iterator find(const Key& key) const {
+    return begin() + find_index(key);
+  }
+
+  // O(log N)
+  bool contains(const Key& key) const {
+    return find_index(key) != size();
+  }
+
+  // O(log N)
+  size_t count(const Key& key) const {
+    return contains(key);
+  }
+
+  // O(log N)
+  iterator lower_bound(const Key& key) {
+    return begin() + lower_bound_index(key);
+  }
+
+  // O(log N)
+  const_iterator lower_bound(const Key& key) const {
+    return begin() + lower_bound_index(key);
+  }
+
+  // O(1) nothrow
+  void swap(flat_map& other) noexcept {
+    using std::swap;
+    swap(keys_, other.keys_);
+    swap(values_, other.values_);
+    swap(comp_, other.comp_);
+  }
+
+  // O(1) nothrow
+  friend void swap(flat_map& lhs, flat_map& rhs) noexcept {
+    lhs.swap(rhs);
+  }
+
+  // O(N)
+  friend bool operator==(const flat_map& lhs, const flat_map& rhs) {
+    return lhs.keys_ == rhs.keys_ && lhs.values_ == rhs.values_;
+  }
+
+private:
+  struct sorted_elements {
+    KeyContainer keys;
+    MappedContainer values;
+  };
+
+  size_t lower_bound_index(const Key& key) const {
+    return detail::branchless_lower_bound(keys_.data(), keys_.size(), key, comp_);
+  }
+
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> emplace_key(K&& key, Args&&... args) {
+    size_t index = lower_bound_index(key);
+    if (index != size() && !comp_(key, keys_[index])) {
+      return {begin() + index, false};
+    }
+    keys_.insert(keys_.begin() + index, std::forward<K>(key));
+    try {
+      values_.emplace(values_.begin() + index, std::forward<Args>(args)...);
+    } catch (...) {
+      keys_.erase(keys_.begin() + index);
+      throw;
+    }
+    return {begin() + index, true};
+  }
+
+  size_t find_index(const Key& key) const {
+    size_t index = lower_bound_index(key);
+    return index != size() && !comp_(key, keys_[index]) ? index : size();
+  }
+
+  // Sorts the elements by key through a permutation, so that keys and values are moved only once, and drops
+  // all the equivalent keys but the first
+  sorted_elements sort_unique(KeyContainer keys, MappedContainer values) const {
+    vector<size_t> order;
+    order.reserve(keys.size());
+    for (size_t i = 0; i != keys.size(); ++i) {
+      order.push_back(i);
+    }
+    // Ties are broken by position instead of using `std::stable_sort`, which needs a temporary buffer
+    std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+      return comp_(keys[lhs], keys[rhs]) || (!comp_(keys[rhs], keys[lhs]) && lhs < rhs);
+    });
+    sorted_elements result;
+    result.keys.reserve(keys.size());
+    result.values.reserve(keys.size());
+    for (size_t i : order) {
+      if (result.keys.empty() || comp_(result.keys.back(), keys[i])) {
+        result.keys.push_back(std::move(keys[i]));
+        result.values.push_back(std::move(values[i]));
+      }
+    }
+    return result;
+  }
+
+  // Existing elements are moved to the merged buffer only if neither keys nor values can throw on move,
+  // otherwise a value that fails to copy would leave its key already moved out
+  static constexpr bool nothrow_move_elements =
+      std::is_nothrow_move_constructible_v<Key> && std::is_nothrow_move_constructible_v<T>;
+
+  // Merges sorted unique elements into the map, keeping the existing values of equal keys
+  void merge_sorted(sorted_elements other) {
+    if (empty()) {
+      keys_.swap(other.keys);
+      values_.swap(other.values);
+      return;
+    }
+    sorted_elements result;
+    result.keys.reserve(size() + other.keys.size());
+    result.values.reserve(size() + other.keys.size());
+    size_t i = 0;
+    size_t j = 0;
+    while (i != size() || j != other.keys.size()) {
+      if (j == other.keys.size() || (i != size() && !comp_(other.keys[j], keys_[i]))) {
+        if (j != other.keys.size() && !comp_(keys_[i], other.keys[j])) {
+          ++j;
+        }
+        if constexpr (nothrow_move_elements) {
+          result.keys.push_back(std::move(keys_[i]));
+          result.values.push_back(std::move(values_[i]));
+        } else {
+          result.keys.push_back(keys_[i]);
+          result.values.push_back(values_[i]);
+        }
+        ++i;
+      } else {
+        result.keys.push_back(std::move(other.keys[j]));
+        result.values.push_back(std::move(other.values[j]));
+        ++j;
+      }
+    }
+    keys_.swap(result.keys);
+    values_.swap(result.values);
+  }
+
+private:
+  KeyContainer keys_;
+  MappedContainer values_;
+  [[no_unique_address]] Compare comp_;
+};
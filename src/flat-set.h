@@ -0,0 +1,269 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+namespace detail {
+
+// Index of the first element of sorted `[data, data + size)` not less than `key`. The loop has no data-dependent
+// branches, only a conditional move, so lookups don't stall on mispredictions
+template <typename T, typename K, typename Compare>
+constexpr size_t branchless_lower_bound(const T* data, size_t size, const K& key, const Compare& comp) {
+  const T* base = data;
+  while (size > 1) {
+    size_t half = size / 2;
+    base = comp(base[half - 1], key) ? base + half : base;
+    size -= half;
+  }
+  return base - data + (size == 1 && comp(*base, key));
+}
+
+} // namespace detail
+
+// Set that stores its keys sorted in a contiguous container, like `std::flat_set`. Lookups are binary searches
+// over contiguous memory, insertions and erasures shift the elements after the position
+template <typename Key, typename Compare = std::less<Key>, typename KeyContainer = vector<Key>>
+class flat_set {
+public:
+  using key_type = Key;
+  using value_type = Key;
+  using key_compare = Compare;
+  using value_compare = Compare;
+  using container_type = KeyContainer;
+
+  using reference = const Key&;
+  using const_reference = const Key&;
+
+  using iterator = typename KeyContainer::const_iterator;
+  using const_iterator = typename KeyContainer::const_iterator;
+
+  // O(1) nothrow
+  flat_set() = default;
+
+  // O(1) nothrow
+  explicit flat_set(const Compare& comp)
+      : comp_(comp) {}
+
+  // O(N log N) strong, keeps the first of equivalent keys
+  explicit flat_set(KeyContainer keys, const Compare& comp = Compare())
+      : comp_(comp) {
+    keys_ = sort_unique(std::move(keys));
+  }
+
+  // O(N log N) strong
+  template <std::input_iterator InputIt>
+  flat_set(InputIt first, InputIt last, const Compare& comp = Compare())
+      : comp_(comp) {
+    insert(first, last);
+  }
+
+  // O(N log N) strong
+  flat_set(std::initializer_list<Key> keys, const Compare& comp = Compare())
+      : flat_set(keys.begin(), keys.end(), comp) {}
+
+  // O(1) nothrow
+  iterator begin() const noexcept {
+    return keys_.begin();
+  }
+
+  // O(1) nothrow
+  iterator end() const noexcept {
+    return keys_.end();
+  }
+
+  // O(1) nothrow
+  size_t size() const noexcept {
+    return keys_.size();
+  }
+
+  // O(1) nothrow
+  bool empty() const noexcept {
+    return keys_.empty();
+  }
+
+  // O(N) strong
+  void reserve(size_t new_capacity) {
+    keys_.reserve(new_capacity);
+  }
+
+  // O(N) nothrow
+  void clear() noexcept {
+    keys_.clear();
+  }
+
+  // O(1) nothrow
+  const KeyContainer& keys() const noexcept {
+    return keys_;
+  }
+
+  // O(1) nothrow, leaves the set empty
+  KeyContainer extract() && noexcept {
+    return std::move(keys_);
+  }
+
+  // O(1) nothrow
+  key_compare key_comp() const {
+    return comp_;
+  }
+
+  // O(N) strong if moving doesn't throw, basic otherwise
+  std::pair<iterator, bool> insert(const Key& key) {
+    return emplace(key);
+  }
+
+  // O(N) strong if moving doesn't throw, basic otherwise
+  std::pair<iterator, bool> insert(Key&& key) {
+    return emplace(std::move(key));
+  }
+
+  // O(N) strong if moving doesn't throw, basic otherwise
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    Key key(std::forward<Args>(args)...);
+    size_t index = lower_bound_index(key);
+    if (index != keys_.size() && !comp_(key, keys_[index])) {
+      return {begin() + index, false};
+    }
+    return {keys_.insert(keys_.begin() + index, std::move(key)), true};
+  }
+
+  // O(N + M log M) strong if the comparison doesn't throw, basic otherwise. The new keys are sorted and merged
+  // with the old ones in a single pass, keeping the existing ones of equivalent keys
+  template <std::input_iterator InputIt>
+  void insert(InputIt first, InputIt last) {
+    KeyContainer keys;
+    keys.insert(keys.end(), first, last);
+    merge_sorted(sort_unique(std::move(keys)));
+  }
+
+  // O(N + M log M) strong if the comparison doesn't throw, basic otherwise
+  void insert(std::initializer_list<Key> keys) {
+    insert(keys.begin(), keys.end());
+  }
+
+  // O(N) nothrow(move)
+  iterator erase(const_iterator pos) {
+    return keys_.erase(pos);
+  }
+
+  // O(N) nothrow(move)
+  iterator erase(const_iterator first, const_iterator last) {
+    return keys_.erase(first, last);
+  }
+
+  // O(N) nothrow(move), returns the number of erased keys
+  size_t erase(const Key& key) {
+    size_t index = lower_bound_index(key);
+    if (index == keys_.size() || comp_(key, keys_[index])) {
+      return 0;
+    }
+    keys_.erase(keys_.begin() + index);
+    return 1;
+  }
+
+  // O(log N)
+  iterator find(const Key& key) const {
+    size_t index = lower_bound_index(key);
+    return index != keys_.size() && !comp_(key, keys_[index]) ? begin() + index : end();
+  }
+
+  // O(log N)
+  bool contains(const Key& key) const {
+    return find(key) != end();
+  }
+
+  // O(log N)
+  size_t count(const Key& key) const {
+    return contains(key);
+  }
+
+  // O(log N)
+  iterator lower_bound(const Key& key) const {
+    return begin() + lower_bound_index(key);
+  }
+
+  // O(log N)
+  iterator upper_bound(const Key& key) const {
+    auto not_greater = [this](const Key& element, const Key& k) { return !comp_(k, element); };
+    return begin() + detail::branchless_lower_bound(keys_.data(), keys_.size(), key, not_greater);
+  }
+
+  // O(1) nothrow
+  void swap(flat_set& other) noexcept {
+    using std::swap;
+    swap(keys_, other.keys_);
+    swap(comp_, other.comp_);
+  }
+
+  // O(1) nothrow
+  friend void swap(flat_set& lhs, flat_set& rhs) noexcept {
+    lhs.swap(rhs);
+  }
+
+  // O(N)
+  friend bool operator==(const flat_set& lhs, const flat_set& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+private:
+  size_t lower_bound_index(const Key& key) const {
+    return detail::branchless_lower_bound(keys_.data(), keys_.size(), key, comp_);
+  }
+
+  // Sorts the keys through a permutation and drops all the equivalent keys but the first
+  KeyContainer sort_unique(KeyContainer keys) const {
+    vector<size_t> order;
+    order.reserve(keys.size());
+    for (size_t i = 0; i != keys.size(); ++i) {
+      order.push_back(i);
+    }
+    // Ties are broken by position instead of using `std::stable_sort`, which needs a temporary buffer
+    std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+      return comp_(keys[lhs], keys[rhs]) || (!comp_(keys[rhs], keys[lhs]) && lhs < rhs);
+    });
+    KeyContainer result;
+    result.reserve(keys.size());
+    for (size_t i : order) {
+      if (result.empty() || comp_(result.back(), keys[i])) {
+        result.push_back(std::move(keys[i]));
+      }
+    }
+    return result;
+  }
+
+  // Merges sorted unique keys into the set, keeping the existing ones of equivalent keys. The existing keys are
+  // moved if that can't throw, copied otherwise
+  void merge_sorted(KeyContainer other) {
+    if (keys_.empty()) {
+      keys_.swap(other);
+      return;
+    }
+    KeyContainer result;
+    result.reserve(keys_.size() + other.size());
+    size_t i = 0;
+    size_t j = 0;
+    while (i != keys_.size() || j != other.size()) {
+      if (j == other.size() || (i != keys_.size() && !comp_(other[j], keys_[i]))) {
+        if (j != other.size() && !comp_(keys_[i], other[j])) {
+          ++j;
+        }
+        result.push_back(std::move_if_noexcept(keys_[i]));
+        ++i;
+      } else {
+        result.push_back(std::move(other[j]));
+        ++j;
+      }
+    }
+    keys_.swap(result);
+  }
+
+private:
+  KeyContainer keys_;
+  [[no_unique_address]] Compare comp_;
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+// Growth policies decide the capacity of a `vector` when appending elements requires a reallocation.
+// A policy provides `static size_t grow(size_t capacity, size_t required, size_t element_size) noexcept`,
+// which returns a new capacity (in elements) not less than `required`. Explicit requests, such as `reserve`
+// or copying, allocate exactly what was asked for and don't consult the policy. The policy must be `constexpr`
+// for the vector to grow during constant evaluation.
+
+#if defined(__GNUC__) && defined(__ELF__)
+// Provided by jemalloc and tcmalloc, null when the program uses another allocator
+extern "C" size_t nallocx(size_t size, int flags) __attribute__((weak));
+#endif
+
+namespace detail {
+
+inline constexpr size_t page_size = size_t(4) << 10;
+inline constexpr size_t huge_page_size = size_t(2) << 20;
+
+constexpr size_t round_up(size_t value, size_t alignment) noexcept {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+// Size of the block that `malloc` actually reserves for a request of `bytes`
+inline size_t malloc_size_class(size_t bytes) noexcept {
+#if defined(__GNUC__) && defined(__ELF__)
+  if (nallocx != nullptr) {
+    return nallocx(bytes, 0);
+  }
+#endif
+#if defined(__GLIBC__)
+  // glibc keeps a size word in front of the chunk, and serves large requests with `mmap`
+  constexpr size_t header = sizeof(size_t);
+  constexpr size_t mmap_threshold = size_t(128) << 10;
+  if (bytes + header >= mmap_threshold) {
+    return round_up(bytes + 2 * header, page_size) - 2 * header;
+  }
+  return std::max(round_up(bytes + header, 2 * sizeof(size_t)), 4 * sizeof(size_t)) - header;
+#else
+  return bytes;
+#endif
+}
+
+} // namespace detail
+
+// Multiplies the capacity by `Numerator / Denominator`. Factors below the golden ratio (such as 1.5)
+// let a sequence of reallocations eventually reuse the memory freed by the previous ones.
+template <size_t Numerator, size_t Denominator = 1>
+struct growth_factor {
+  static_assert(Numerator > Denominator && Denominator > 0);
+
+  static constexpr size_t grow(size_t capacity, size_t required, size_t /*element_size*/) noexcept {
+    size_t grown = capacity > std::numeric_limits<size_t>::max() / Numerator
+                     ? std::numeric_limits<size_t>::max()
+                     : capacity * Numerator / Denominator;
+    return std::max({required, grown, size_t(1)});
+  }
+};
+
+using doubling_growth = growth_factor<2>;
+using one_and_a_half_growth = growth_factor<3, 2>;
+
+// Rounds buffers of at least `PageThreshold` bytes up to whole pages, and buffers of at least
+// `HugePageThreshold` bytes up to whole huge pages, so that the tail of the last page isn't wasted and
+// transparent huge pages can back the whole buffer
+template <typename Base = doubling_growth, size_t PageThreshold = detail::page_size,
+          size_t HugePageThreshold = detail::huge_page_size>
+struct page_rounding_growth {
+  static constexpr size_t grow(size_t capacity, size_t required, size_t element_size) noexcept {
+    size_t result = Base::grow(capacity, required, element_size);
+    size_t bytes = result * element_size;
+    if (bytes >= HugePageThreshold) {
+      bytes = detail::round_up(bytes, detail::huge_page_size);
+    } else if (bytes >= PageThreshold) {
+      bytes = detail::round_up(bytes, detail::page_size);
+    }
+    return std::max(result, bytes / element_size);
+  }
+};
+
+// Extends the capacity to the whole block the allocator would reserve anyway. Only meaningful for
+// allocators that are backed by `malloc`, such as `std::allocator`.
+template <typename Base = doubling_growth>
+struct size_class_growth {
+  static size_t grow(size_t capacity, size_t required, size_t element_size) noexcept {
+    size_t result = Base::grow(capacity, required, element_size);
+    return std::max(result, detail::malloc_size_class(result * element_size) / element_size);
+  }
+};
+
+using default_growth = doubling_growth;
@@ -0,0 +1,399 @@
+#pragma once
+
+#include "vector-checks.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Vector of at most `N` elements stored inside the object itself, like C++26 `std::inplace_vector`. It never
+// allocates: insertions beyond the capacity throw `std::bad_alloc`, and `try_push_back` / `try_emplace_back`
+// return null instead. Copying, moving and destruction are trivial when they are for `T`, so a vector of
+// trivially copyable elements is trivially copyable itself
+template <typename T, size_t N>
+class inplace_vector {
+public:
+  using value_type = T;
+
+  using reference = T&;
+  using const_reference = const T&;
+
+  using pointer = T*;
+  using const_pointer = const T*;
+
+  using iterator = pointer;
+  using const_iterator = const_pointer;
+
+  // O(1) nothrow
+  inplace_vector() noexcept = default;
+
+  // O(N) strong
+  inplace_vector(std::initializer_list<T> values) {
+    insert_end(values.begin(), values.end());
+  }
+
+  // O(N) strong
+  template <std::input_iterator InputIt>
+  inplace_vector(InputIt first, InputIt last) {
+    insert_end(first, last);
+  }
+
+  inplace_vector(const inplace_vector&)
+    requires std::is_trivially_copy_constructible_v<T>
+  = default;
+
+  // O(N) strong
+  inplace_vector(const inplace_vector& other) {
+    insert_end(other.begin(), other.end());
+  }
+
+  inplace_vector(inplace_vector&&)
+    requires std::is_trivially_move_constructible_v<T>
+  = default;
+
+  // O(N) nothrow(move), `other` keeps its elements in the moved-from state
+  inplace_vector(inplace_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    insert_end(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+  }
+
+  inplace_vector& operator=(const inplace_vector&)
+    requires std::is_trivially_copyable_v<T>
+  = default;
+
+  // O(N + M) basic
+  inplace_vector& operator=(const inplace_vector& other) {
+    if (this != &other) {
+      assign_range(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  inplace_vector& operator=(inplace_vector&&)
+    requires std::is_trivially_copyable_v<T>
+  = default;
+
+  // O(N + M) nothrow(move)
+  inplace_vector& operator=(inplace_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    if (this != &other) {
+      assign_range(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+    }
+    return *this;
+  }
+
+  ~inplace_vector()
+    requires std::is_trivially_destructible_v<T>
+  = default;
+
+  // O(N) nothrow
+  ~inplace_vector() noexcept {
+    clear();
+  }
+
+  // O(1) nothrow
+  reference operator[](size_t index) {
+    detail::check(index < size_, "index out of range");
+    return data()[index];
+  }
+
+  // O(1) nothrow
+  const_reference operator[](size_t index) const {
+    detail::check(index < size_, "index out of range");
+    return data()[index];
+  }
+
+  // O(1) nothrow
+  pointer data() noexcept {
+    if constexpr (N == 0) {
+      return nullptr;
+    } else {
+      return std::launder(reinterpret_cast<T*>(storage_.bytes));
+    }
+  }
+
+  // O(1) nothrow
+  const_pointer data() const noexcept {
+    if constexpr (N == 0) {
+      return nullptr;
+    } else {
+      return std::launder(reinterpret_cast<const T*>(storage_.bytes));
+    }
+  }
+
+  // O(1) nothrow
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  // O(1) nothrow
+  static constexpr size_t capacity() noexcept {
+    return N;
+  }
+
+  // O(1) nothrow
+  static constexpr size_t max_size() noexcept {
+    return N;
+  }
+
+  // O(1) nothrow
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  // O(1) nothrow
+  bool full() const noexcept {
+    return size_ == N;
+  }
+
+  // O(1) nothrow
+  reference front() {
+    detail::check(size_ != 0, "front() of an empty vector");
+    return data()[0];
+  }
+
+  // O(1) nothrow
+  const_reference front() const {
+    detail::check(size_ != 0, "front() of an empty vector");
+    return data()[0];
+  }
+
+  // O(1) nothrow
+  reference back() {
+    detail::check(size_ != 0, "back() of an empty vector");
+    return data()[size_ - 1];
+  }
+
+  // O(1) nothrow
+  const_reference back() const {
+    detail::check(size_ != 0, "back() of an empty vector");
+    return data()[size_ - 1];
+  }
+
+  // O(1) strong, throws `std::bad_alloc` if the vector is full
+  void push_back(const T& value) {
+    emplace_back(value);
+  }
+
+  // O(1) strong, throws `std::bad_alloc` if the vector is full
+  void push_back(T&& value) {
+    emplace_back(std::move(value));
+  }
+
+  // O(1) strong, throws `std::bad_alloc` if the vector is full
+  template <typename... Args>
+  reference emplace_back(Args&&... args) {
+    if (full()) {
+      throw std::bad_alloc();
+    }
+    return unchecked_emplace_back(std::forward<Args>(args)...);
+  }
+
+  // O(1) strong, returns null if the vector is full
+  pointer try_push_back(const T& value) {
+    return try_emplace_back(value);
+  }
+
+  // O(1) strong, returns null if the vector is full, leaving `value` intact
+  pointer try_push_back(T&& value) {
+    return try_emplace_back(std::move(value));
+  }
+
+  // O(1) strong, returns null if the vector is full
+  template <typename... Args>
+  pointer try_emplace_back(Args&&... args) {
+    if (full()) {
+      return nullptr;
+    }
+    return &unchecked_emplace_back(std::forward<Args>(args)...);
+  }
+
+  // O(1) strong, the vector must not be full
+  void unchecked_push_back(const T& value) {
+    unchecked_emplace_back(value);
+  }
+
+  // O(1) strong, the vector must not be full
+  void unchecked_push_back(T&& value) {
+    unchecked_emplace_back(std::move(value));
+  }
+
+  // O(1) strong, the vector must not be full
+  template <typename... Args>
+  reference unchecked_emplace_back(Args&&... args) {
+    detail::check(!full(), "unchecked_emplace_back() of a full vector");
+    T* slot = std::construct_at(data() + size_, std::forward<Args>(args)...);
+    ++size_;
+    return *slot;
+  }
+
+  // O(1) nothrow
+  void pop_back() {
+    detail::check(size_ != 0, "pop_back() of an empty vector");
+    --size_;
+    std::destroy_at(data() + size_);
+  }
+
+  // O(N) nothrow
+  void clear() noexcept {
+    destroy_tail(0);
+  }
+
+  // O(M) strong, throws `std::bad_alloc` if `count` exceeds the capacity
+  void resize(size_t count)
+    requires std::default_initializable<T>
+  {
+    resize_with(count, [this] { unchecked_emplace_back(); });
+  }
+
+  // O(M) strong, throws `std::bad_alloc` if `count` exceeds the capacity
+  void resize(size_t count, const T& value) {
+    resize_with(count, [&] { unchecked_emplace_back(value); });
+  }
+
+  // O(1) nothrow
+  iterator begin() noexcept {
+    return data();
+  }
+
+  // O(1) nothrow
+  iterator end() noexcept {
+    return data() + size_;
+  }
+
+  // O(1) nothrow
+  const_iterator begin() const noexcept {
+    return data();
+  }
+
+  // O(1) nothrow
+  const_iterator end() const noexcept {
+    return data() + size_;
+  }
+
+  // O(N) strong if swap doesn't throw, basic otherwise. Throws `std::bad_alloc` if the vector is full
+  iterator insert(const_iterator pos, const T& value) {
+    return emplace(pos, value);
+  }
+
+  // O(N) strong if swap doesn't throw, basic otherwise. Throws `std::bad_alloc` if the vector is full
+  iterator insert(const_iterator pos, T&& value) {
+    return emplace(pos, std::move(value));
+  }
+
+  // O(N) strong if swap doesn't throw, basic otherwise. Throws `std::bad_alloc` if the vector is full.
+  // The element is constructed at the end and rotated into place, so `args` may refer to an element
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args) {
+    size_t index = pos - data();
+    emplace_back(std::forward<Args>(args)...);
+    std::rotate(begin() + index, end() - 1, end());
+    return begin() + index;
+  }
+
+  // O(N) nothrow(move)
+  iterator erase(const_iterator pos) {
+    return erase(pos, pos + 1);
+  }
+
+  // O(N) nothrow(move)
+  iterator erase(const_iterator first, const_iterator last) {
+    size_t index = first - data();
+    std::move(begin() + (last - data()), end(), begin() + index);
+    destroy_tail(size_ - (last - first));
+    return begin() + index;
+  }
+
+  // O(N + M) nothrow(swap)
+  void swap(inplace_vector& other) noexcept(
+      std::is_nothrow_swappable_v<T> && std::is_nothrow_move_constructible_v<T>
+  ) {
+    inplace_vector& shorter = size_ < other.size_ ? *this : other;
+    inplace_vector& longer = size_ < other.size_ ? other : *this;
+    size_t common = shorter.size_;
+    std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+    shorter.insert_end(std::make_move_iterator(longer.begin() + common), std::make_move_iterator(longer.end()));
+    longer.destroy_tail(common);
+  }
+
+  // O(N + M) nothrow(swap)
+  friend void swap(inplace_vector& lhs, inplace_vector& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+  }
+
+  // O(N)
+  friend bool operator==(const inplace_vector& lhs, const inplace_vector& rhs)
+    requires std::equality_comparable<T>
+  {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+  // O(N), lexicographic
+  friend auto operator<=>(const inplace_vector& lhs, const inplace_vector& rhs)
+    requires std::three_way_comparable<T>
+  {
+    return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+private:
+  // Destroys elements after `count` in reverse order of their construction
+  void destroy_tail(size_t count) noexcept {
+    if constexpr (std::is_trivially_destructible_v<T>) {
+      size_ = count;
+    } else {
+      while (size_ != count) {
+        pop_back();
+      }
+    }
+  }
+
+  // Strong: the appended elements are destroyed if any of them throws
+  template <typename It>
+  void insert_end(It first, It last) {
+    size_t old_size = size_;
+    try {
+      for (; first != last; ++first) {
+        emplace_back(*first);
+      }
+    } catch (...) {
+      destroy_tail(old_size);
+      throw;
+    }
+  }
+
+  template <typename It>
+  void assign_range(It first, It last) {
+    clear();
+    insert_end(first, last);
+  }
+
+  template <typename Construct>
+  void resize_with(size_t count, Construct construct) {
+    if (count > N) {
+      throw std::bad_alloc();
+    }
+    if (count <= size_) {
+      destroy_tail(count);
+      return;
+    }
+    size_t old_size = size_;
+    try {
+      while (size_ != count) {
+        construct();
+      }
+    } catch (...) {
+      destroy_tail(old_size);
+      throw;
+    }
+  }
+
+private:
+  [[no_unique_address]] detail::inline_storage<T, N> storage_;
+  size_t size_ = 0;
+};
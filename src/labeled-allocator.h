@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+// Allocation events of `labeled_allocator`, reported to the hook installed with `set_allocation_hook`. The hook
+// can forward them to a heap profiler, e.g. keep a map from `ptr` to `label` and look the label up in the
+// allocation stacks of jemalloc or tcmalloc profiles, or emit heaptrack / custom markers.
+// It is called on every allocation and deallocation, from any thread, and must not throw or allocate through a
+// `labeled_allocator` itself
+struct allocation_event {
+  const char* label;
+  void* ptr;
+  size_t bytes;
+  // `false` for deallocations
+  bool allocated;
+};
+
+using allocation_hook = void (*)(const allocation_event&) noexcept;
+
+namespace detail {
+
+inline std::atomic<allocation_hook> current_allocation_hook = nullptr;
+
+inline void report_allocation(const char* label, void* ptr, size_t bytes, bool allocated) noexcept {
+  if (allocation_hook hook = current_allocation_hook.load(std::memory_order_acquire)) {
+    hook({label, ptr, bytes, allocated});
+  }
+}
+
+} // namespace detail
+
+// Returns the previous hook, null removes it
+inline allocation_hook set_allocation_hook(allocation_hook hook) noexcept {
+  return detail::current_allocation_hook.exchange(hook, std::memory_order_acq_rel);
+}
+
+// Allocates with `Base` and reports every allocation and deallocation with `label` to the allocation hook.
+// Allocators with different labels are equal, so buffers move freely between vectors. Buffers keep their label
+// when a vector is moved or swapped, a copy keeps the label of the target
+template <typename T, typename Base = std::allocator<T>>
+class labeled_allocator {
+  using base_traits = std::allocator_traits<Base>;
+
+public:
+  using value_type = T;
+  using is_always_equal = typename base_traits::is_always_equal;
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template <typename U>
+  struct rebind {
+    using other = labeled_allocator<U, typename base_traits::template rebind_alloc<U>>;
+  };
+
+  labeled_allocator() = default;
+
+  // `label` must outlive all the buffers allocated with it
+  explicit labeled_allocator(const char* label, const Base& base = Base()) noexcept
+      : base_(base)
+      , label_(label) {}
+
+  template <typename U, typename UBase>
+  labeled_allocator(const labeled_allocator<U, UBase>& other) noexcept
+      : base_(other.base())
+      , label_(other.label()) {}
+
+  const char* label() const noexcept {
+    return label_;
+  }
+
+  const Base& base() const noexcept {
+    return base_;
+  }
+
+  T* allocate(size_t count) {
+    T* result = base_traits::allocate(base_, count);
+    detail::report_allocation(label_, result, count * sizeof(T), true);
+    return result;
+  }
+
+  void deallocate(T* ptr, size_t count) noexcept {
+    detail::report_allocation(label_, ptr, count * sizeof(T), false);
+    base_traits::deallocate(base_, ptr, count);
+  }
+
+  template <typename U, typename UBase>
+  friend bool operator==(const labeled_allocator& lhs, const labeled_allocator<U, UBase>& rhs) noexcept {
+    return lhs.base() == rhs.base();
+  }
+
+private:
+  [[no_unique_address]] Base base_;
+  const char* label_ = "vector";
+};
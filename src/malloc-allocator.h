@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+// Allocates with `std::malloc` and deallocates with `std::free`, so buffers can be exchanged with C code,
+// e.g. with `vector::from_raw` and `vector::release`
+template <typename T>
+struct malloc_allocator {
+  static_assert(alignof(T) <= alignof(std::max_align_t), "malloc doesn't support over-aligned types");
+
+  using value_type = T;
+  using is_always_equal = std::true_type;
+
+  malloc_allocator() = default;
+
+  template <typename U>
+  malloc_allocator(const malloc_allocator<U>&) noexcept {}
+
+  T* allocate(size_t count) {
+    if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    void* result = std::malloc(count * sizeof(T));
+    if (result == nullptr) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(result);
+  }
+
+  void deallocate(T* ptr, size_t) noexcept {
+    std::free(ptr);
+  }
+
+  template <typename U>
+  friend bool operator==(const malloc_allocator&, const malloc_allocator<U>&) noexcept {
+    return true;
+  }
+};
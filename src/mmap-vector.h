@@ -0,0 +1,362 @@
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Vector of trivially copyable elements stored in a memory-mapped file, so its contents outlive the process
+// and can be opened again without reading or copying. The file starts with a small header that keeps the
+// size; the rest of the file is the capacity.
+// A moved-from vector has no file: it is empty and can be read, cleared, assigned to or destroyed, but growing
+// it fails with `std::system_error`.
+// Errors of the underlying system calls are reported with `std::system_error`
+template <typename T>
+class mmap_vector {
+  static_assert(std::is_trivially_copyable_v<T>, "mmap_vector requires trivially copyable elements");
+
+  struct header {
+    uint64_t magic;
+    uint64_t element_size;
+    uint64_t size;
+  };
+
+  static constexpr uint64_t magic = 0x726f74636576'6d6d;
+  // Keeps elements aligned, as the mapping itself is page-aligned
+  static constexpr size_t data_offset = std::max<size_t>(64, alignof(T));
+
+  static_assert(sizeof(header) <= data_offset);
+
+public:
+  using value_type = T;
+
+  using reference = T&;
+  using const_reference = const T&;
+
+  using pointer = T*;
+  using const_pointer = const T*;
+
+  using iterator = pointer;
+  using const_iterator = const_pointer;
+
+  // Creates an empty vector in the file at `path`, replacing its previous contents
+  static mmap_vector create(const char* path) {
+    mmap_vector result(open_file(path, O_RDWR | O_CREAT | O_TRUNC));
+    result.map(0);
+    result.get_header()->magic = magic;
+    result.get_header()->element_size = sizeof(T);
+    result.get_header()->size = 0;
+    return result;
+  }
+
+  // Maps a file created by `create` without reading it
+  static mmap_vector open(const char* path) {
+    mmap_vector result(open_file(path, O_RDWR));
+    struct stat st;
+    if (::fstat(result.fd_, &st) != 0) {
+      throw_system_error();
+    }
+    size_t length = st.st_size;
+    if (length < data_offset) {
+      throw std::system_error(std::make_error_code(std::errc::invalid_argument), "mmap_vector: file is too small");
+    }
+    result.mapping_size_ = length;
+    result.mapping_ = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, result.fd_, 0);
+    if (result.mapping_ == MAP_FAILED) {
+      result.mapping_ = nullptr;
+      throw_system_error();
+    }
+    const header* h = result.get_header();
+    size_t capacity = (length - data_offset) / sizeof(T);
+    if (h->magic != magic || h->element_size != sizeof(T) || h->size > capacity) {
+      throw std::system_error(std::make_error_code(std::errc::invalid_argument), "mmap_vector: invalid file");
+    }
+    result.capacity_ = capacity;
+    return result;
+  }
+
+  // O(1) nothrow
+  mmap_vector(mmap_vector&& other) noexcept
+      : fd_(std::exchange(other.fd_, -1))
+      , mapping_(std::exchange(other.mapping_, nullptr))
+      , mapping_size_(std::exchange(other.mapping_size_, 0))
+      , capacity_(std::exchange(other.capacity_, 0)) {}
+
+  // O(1) nothrow
+  mmap_vector& operator=(mmap_vector&& other) noexcept {
+    if (this != &other) {
+      mmap_vector tmp(std::move(other));
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  mmap_vector(const mmap_vector&) = delete;
+  mmap_vector& operator=(const mmap_vector&) = delete;
+
+  // O(1) nothrow, the file is unmapped but its contents stay, use `sync` to wait until they are written
+  ~mmap_vector() noexcept {
+    if (mapping_ != nullptr) {
+      ::munmap(mapping_, mapping_size_);
+    }
+    if (fd_ != -1) {
+      ::close(fd_);
+    }
+  }
+
+  // O(1) nothrow
+  void swap(mmap_vector& other) noexcept {
+    std::swap(fd_, other.fd_);
+    std::swap(mapping_, other.mapping_);
+    std::swap(mapping_size_, other.mapping_size_);
+    std::swap(capacity_, other.capacity_);
+  }
+
+  // O(1) nothrow
+  friend void swap(mmap_vector& lhs, mmap_vector& rhs) noexcept {
+    lhs.swap(rhs);
+  }
+
+  // O(1) nothrow
+  T& operator[](size_t index) {
+    return data()[index];
+  }
+
+  // O(1) nothrow
+  const T& operator[](size_t index) const {
+    return data()[index];
+  }
+
+  // O(1) nothrow, null for a moved-from vector
+  T* data() noexcept {
+    if (mapping_ == nullptr) {
+      return nullptr;
+    }
+    return reinterpret_cast<T*>(static_cast<std::byte*>(mapping_) + data_offset);
+  }
+
+  // O(1) nothrow, null for a moved-from vector
+  const T* data() const noexcept {
+    if (mapping_ == nullptr) {
+      return nullptr;
+    }
+    return reinterpret_cast<const T*>(static_cast<const std::byte*>(mapping_) + data_offset);
+  }
+
+  // O(1) nothrow
+  size_t size() const noexcept {
+    return mapping_ == nullptr ? 0 : get_header()->size;
+  }
+
+  // O(1) nothrow
+  size_t capacity() const noexcept {
+    return capacity_;
+  }
+
+  // O(1) nothrow
+  bool empty() const noexcept {
+    return size() == 0;
+  }
+
+  // O(1) nothrow
+  T& front() {
+    return data()[0];
+  }
+
+  // O(1) nothrow
+  const T& front() const {
+    return data()[0];
+  }
+
+  // O(1) nothrow
+  T& back() {
+    return data()[size() - 1];
+  }
+
+  // O(1) nothrow
+  const T& back() const {
+    return data()[size() - 1];
+  }
+
+  // O(1)* strong
+  void push_back(const T& value) {
+    if (size() == capacity_) {
+      // `value` may be an element that is about to be remapped
+      T copy = value;
+      grow(size() + 1);
+      data()[size()] = copy;
+    } else {
+      data()[size()] = value;
+    }
+    ++get_header()->size;
+  }
+
+  // O(1) nothrow
+  void pop_back() {
+    --get_header()->size;
+  }
+
+  // O(M) strong, new elements are zeroed
+  void resize(size_t count) {
+    if (count > capacity_) {
+      grow(count);
+    }
+    if (count == size()) {
+      return;
+    }
+    if (count > size()) {
+      std::memset(static_cast<void*>(data() + size()), 0, (count - size()) * sizeof(T));
+    }
+    get_header()->size = count;
+  }
+
+  // O(1) strong, grows the file and its mapping without copying the elements where `mremap` is available
+  void reserve(size_t new_capacity) {
+    if (new_capacity > capacity_) {
+      remap(new_capacity);
+    }
+  }
+
+  // O(1) strong, truncates the file to the size
+  void shrink_to_fit() {
+    if (size() != capacity_) {
+      remap(size());
+    }
+  }
+
+  // O(1) nothrow
+  void clear() noexcept {
+    if (mapping_ != nullptr) {
+      get_header()->size = 0;
+    }
+  }
+
+  // O(N) strong, writes the changes to the file, and waits for that unless `async` is set
+  void sync(bool async = false) {
+    if (mapping_ != nullptr && ::msync(mapping_, mapping_size_, async ? MS_ASYNC : MS_SYNC) != 0) {
+      throw_system_error();
+    }
+  }
+
+  // O(1) nothrow
+  iterator begin() noexcept {
+    return data();
+  }
+
+  // O(1) nothrow
+  iterator end() noexcept {
+    return data() + size();
+  }
+
+  // O(1) nothrow
+  const_iterator begin() const noexcept {
+    return data();
+  }
+
+  // O(1) nothrow
+  const_iterator end() const noexcept {
+    return data() + size();
+  }
+
+private:
+  explicit mmap_vector(int fd) noexcept
+      : fd_(fd) {}
+
+  [[noreturn]] static void throw_system_error() {
+    throw std::system_error(errno, std::generic_category(), "mmap_vector");
+  }
+
+  static int open_file(const char* path, int flags) {
+    int fd = ::open(path, flags | O_CLOEXEC, 0644);
+    if (fd == -1) {
+      throw_system_error();
+    }
+    return fd;
+  }
+
+  header* get_header() noexcept {
+    return static_cast<header*>(mapping_);
+  }
+
+  const header* get_header() const noexcept {
+    return static_cast<const header*>(mapping_);
+  }
+
+  static size_t file_size(size_t capacity) {
+    if (capacity > (SIZE_MAX - data_offset) / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    return data_offset + capacity * sizeof(T);
+  }
+
+  void map(size_t capacity) {
+    size_t new_size = file_size(capacity);
+    if (::ftruncate(fd_, new_size) != 0) {
+      throw_system_error();
+    }
+    void* mapping = ::mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+      throw_system_error();
+    }
+    mapping_ = mapping;
+    mapping_size_ = new_size;
+    capacity_ = capacity;
+  }
+
+  void grow(size_t required) {
+    remap(std::max(required, 2 * capacity_));
+  }
+
+  // The file is resized first, so that the mapping never extends beyond it
+  void remap(size_t new_capacity) {
+    if (mapping_ == nullptr) {
+      throw std::system_error(std::make_error_code(std::errc::bad_file_descriptor), "mmap_vector: moved-from");
+    }
+    size_t new_size = file_size(new_capacity);
+    if (new_size > mapping_size_ && ::ftruncate(fd_, new_size) != 0) {
+      throw_system_error();
+    }
+#ifdef MREMAP_MAYMOVE
+    void* mapping = ::mremap(mapping_, mapping_size_, new_size, MREMAP_MAYMOVE);
+#else
+    void* mapping = ::mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+#endif
+    if (mapping == MAP_FAILED) {
+      int error = errno;
+      if (new_size > mapping_size_) {
+        // Restoring the previous length can't fail, as it only shrinks the file
+        [[maybe_unused]] int unused = ::ftruncate(fd_, mapping_size_);
+      }
+      throw std::system_error(error, std::generic_category(), "mmap_vector");
+    }
+#ifndef MREMAP_MAYMOVE
+    ::munmap(mapping_, mapping_size_);
+#endif
+    if (new_size < mapping_size_) {
+      [[maybe_unused]] int unused = ::ftruncate(fd_, new_size);
+    }
+    mapping_ = mapping;
+    mapping_size_ = new_size;
+    capacity_ = new_capacity;
+  }
+
+private:
+  int fd_ = -1;
+  void* mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+  size_t capacity_ = 0;
+};
+
+#endif
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Requests splitting bulk operations of a `vector` between threads. Each thread gets at least `min_chunk_size`
+// elements, so small vectors are still processed in the calling thread. `threads == 0` means
+// `std::thread::hardware_concurrency()`.
+struct parallel_policy {
+  size_t threads = 0;
+  size_t min_chunk_size = size_t(1) << 14;
+};
+
+inline constexpr parallel_policy parallel{};
+
+namespace detail {
+
+inline size_t chunk_count(const parallel_policy& policy, size_t count) noexcept {
+  size_t threads = policy.threads != 0 ? policy.threads : std::max(std::thread::hardware_concurrency(), 1u);
+  return std::clamp<size_t>(count / std::max<size_t>(policy.min_chunk_size, 1), 1, threads);
+}
+
+// Splits `[0, count)` into chunks and calls `body(begin, end)` for them concurrently, the last chunk being
+// processed by the calling thread. If some calls throw, calls `undo(begin, end)` for the chunks that were
+// processed successfully, in reverse order, and rethrows the first exception
+template <typename Body, typename Undo>
+void parallel_for(const parallel_policy& policy, size_t count, Body body, Undo undo) {
+  size_t chunks = chunk_count(policy, count);
+  if (chunks == 1) {
+    body(size_t(0), count);
+    return;
+  }
+
+  auto chunk_begin = [=](size_t chunk) { return count / chunks * chunk + std::min(chunk, count % chunks); };
+  std::vector<std::exception_ptr> errors(chunks);
+  auto run = [&](size_t chunk) noexcept {
+    try {
+      body(chunk_begin(chunk), chunk_begin(chunk + 1));
+    } catch (...) {
+      errors[chunk] = std::current_exception();
+    }
+  };
+
+  {
+    std::vector<std::jthread> threads;
+    threads.reserve(chunks - 1);
+    size_t spawned = 0;
+    try {
+      for (; spawned + 1 < chunks; ++spawned) {
+        threads.emplace_back(run, spawned);
+      }
+    } catch (...) {
+      // Out of threads, the rest of the chunks are processed here
+    }
+    for (size_t chunk = spawned; chunk != chunks; ++chunk) {
+      run(chunk);
+    }
+  }
+
+  auto error = std::find_if(errors.begin(), errors.end(), [](const std::exception_ptr& e) { return e != nullptr; });
+  if (error == errors.end()) {
+    return;
+  }
+  for (size_t chunk = chunks; chunk-- != 0;) {
+    if (errors[chunk] == nullptr) {
+      undo(chunk_begin(chunk), chunk_begin(chunk + 1));
+    }
+  }
+  std::rethrow_exception(*error);
+}
+
+template <typename Body>
+void parallel_for(const parallel_policy& policy, size_t count, Body body) {
+  parallel_for(policy, count, std::move(body), [](size_t, size_t) noexcept {});
+}
+
+} // namespace detail
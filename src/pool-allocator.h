@@ -0,0 +1,216 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+// Per-thread cache of released buffers for `pool_allocator`. Buffers up to `buffer_pool::max_pooled_bytes` are
+// rounded up to a power of two size class. A deallocated buffer goes to the free list of its class in the
+// deallocating thread, and the next allocation of the same class in that thread takes it from there without
+// calling `operator new`. Each thread retains at most `retention_limit()` bytes, the excess is freed immediately.
+// The retained buffers are freed when the thread exits.
+
+struct buffer_pool_stats {
+  // Allocations served from a free list
+  size_t hits = 0;
+  // Allocations that called `operator new`, including the ones too large to be pooled
+  size_t misses = 0;
+  // Deallocations that kept the buffer in a free list
+  size_t recycled = 0;
+  // Deallocations that called `operator delete`: the buffer was too large or the retention limit was reached
+  size_t released = 0;
+  size_t retained_bytes = 0;
+
+  friend bool operator==(const buffer_pool_stats&, const buffer_pool_stats&) = default;
+};
+
+namespace detail {
+
+class thread_buffer_pool {
+public:
+  static constexpr size_t min_block_bytes = 16;
+  static constexpr size_t class_count = 16;
+  static constexpr size_t max_block_bytes = min_block_bytes << (class_count - 1);
+  static constexpr size_t default_retention_limit = size_t(4) << 20;
+
+  static_assert(min_block_bytes >= sizeof(void*));
+
+  // Block size of the class for `bytes`, `bytes` itself if it's too large to be pooled
+  static constexpr size_t block_size(size_t bytes) noexcept {
+    return bytes > max_block_bytes ? bytes : std::max(std::bit_ceil(bytes), min_block_bytes);
+  }
+
+  static thread_buffer_pool& local() noexcept {
+    // The pool itself is trivially destructible, so buffers deallocated by other thread-local objects after
+    // `closer` has run still see it, closed
+    thread_local thread_buffer_pool pool;
+    thread_local closer close_at_exit{pool};
+    return pool;
+  }
+
+  void* allocate(size_t bytes) {
+    if (bytes <= max_block_bytes && !closed_) {
+      size_t index = class_index(bytes);
+      if (free_block* block = free_lists_[index]) {
+        free_lists_[index] = block->next;
+        retained_bytes_ -= block_size(bytes);
+        ++stats_.hits;
+        return block;
+      }
+    }
+    ++stats_.misses;
+    return ::operator new(block_size(bytes));
+  }
+
+  void deallocate(void* ptr, size_t bytes) noexcept {
+    size_t size = block_size(bytes);
+    if (bytes > max_block_bytes || closed_ || retained_bytes_ + size > retention_limit_) {
+      ++stats_.released;
+      ::operator delete(ptr, size);
+      return;
+    }
+    size_t index = class_index(bytes);
+    free_lists_[index] = ::new (ptr) free_block{free_lists_[index]};
+    retained_bytes_ += size;
+    ++stats_.recycled;
+  }
+
+  // Frees all retained buffers
+  void trim() noexcept {
+    for (size_t i = 0; i < class_count; ++i) {
+      while (free_block* block = free_lists_[i]) {
+        free_lists_[i] = block->next;
+        ::operator delete(block, min_block_bytes << i);
+      }
+    }
+    retained_bytes_ = 0;
+  }
+
+  size_t retention_limit() const noexcept {
+    return retention_limit_;
+  }
+
+  // Doesn't free buffers retained above the new limit until `trim`
+  void set_retention_limit(size_t bytes) noexcept {
+    retention_limit_ = bytes;
+  }
+
+  buffer_pool_stats stats() const noexcept {
+    buffer_pool_stats result = stats_;
+    result.retained_bytes = retained_bytes_;
+    return result;
+  }
+
+  void reset_stats() noexcept {
+    stats_ = {};
+  }
+
+private:
+  struct free_block {
+    free_block* next;
+  };
+
+  struct closer {
+    thread_buffer_pool& pool;
+
+    ~closer() {
+      pool.trim();
+      pool.closed_ = true;
+    }
+  };
+
+  static size_t class_index(size_t bytes) noexcept {
+    return std::countr_zero(block_size(bytes) / min_block_bytes);
+  }
+
+private:
+  free_block* free_lists_[class_count] = {};
+  size_t retained_bytes_ = 0;
+  size_t retention_limit_ = default_retention_limit;
+  bool closed_ = false;
+  buffer_pool_stats stats_;
+};
+
+} // namespace detail
+
+// Access to the pool of the calling thread
+struct buffer_pool {
+  static constexpr size_t max_pooled_bytes = detail::thread_buffer_pool::max_block_bytes;
+
+  // O(1) nothrow
+  static buffer_pool_stats stats() noexcept {
+    return detail::thread_buffer_pool::local().stats();
+  }
+
+  // O(1) nothrow, keeps `retained_bytes`
+  static void reset_stats() noexcept {
+    detail::thread_buffer_pool::local().reset_stats();
+  }
+
+  // O(1) nothrow
+  static size_t retention_limit() noexcept {
+    return detail::thread_buffer_pool::local().retention_limit();
+  }
+
+  // O(1) nothrow
+  static void set_retention_limit(size_t bytes) noexcept {
+    detail::thread_buffer_pool::local().set_retention_limit(bytes);
+  }
+
+  // O(N) nothrow, frees the buffers retained by the calling thread
+  static void trim() noexcept {
+    detail::thread_buffer_pool::local().trim();
+  }
+};
+
+// Allocates through the pool of the calling thread. Buffers may be deallocated by any thread, they join the pool
+// of the deallocating one
+template <typename T>
+struct pool_allocator {
+  static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "the pool doesn't support over-aligned types");
+
+  using value_type = T;
+  using is_always_equal = std::true_type;
+
+  pool_allocator() = default;
+
+  template <typename U>
+  pool_allocator(const pool_allocator<U>&) noexcept {}
+
+  T* allocate(size_t count) {
+    if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    return static_cast<T*>(detail::thread_buffer_pool::local().allocate(count * sizeof(T)));
+  }
+
+  void deallocate(T* ptr, size_t count) noexcept {
+    detail::thread_buffer_pool::local().deallocate(ptr, count * sizeof(T));
+  }
+
+  template <typename U>
+  friend bool operator==(const pool_allocator&, const pool_allocator<U>&) noexcept {
+    return true;
+  }
+};
+
+// Extends the capacity to the whole size class of the pool, so that the buffer is reused by any vector that grows
+// to the same class
+template <typename Base = default_growth>
+struct pool_growth {
+  static constexpr size_t grow(size_t capacity, size_t required, size_t element_size) noexcept {
+    size_t result = Base::grow(capacity, required, element_size);
+    if (result > buffer_pool::max_pooled_bytes / element_size) {
+      return result;
+    }
+    return detail::thread_buffer_pool::block_size(result * element_size) / element_size;
+  }
+};
+
+template <typename T>
+using pooled_vector = vector<T, pool_allocator<T>, 0, pool_growth<>>;
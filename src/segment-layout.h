@@ -0,0 +1,39 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+
+namespace detail {
+
+// Index arithmetic shared by the segmented containers. Segment `s` holds `2^(s + first_segment_bits)` elements
+// and starts at index `2^first_segment_bits * (2^s - 1)`, so the first `s` segments hold as many elements as
+// the next one
+struct segment_layout {
+  static constexpr size_t first_segment_bits = 5;
+  // Enough for every index up to the maximum size
+  static constexpr size_t max_segment_count = sizeof(size_t) * 8 - first_segment_bits;
+
+  static constexpr size_t segment_size(size_t segment) noexcept {
+    return size_t(1) << (segment + first_segment_bits);
+  }
+
+  static constexpr size_t segment_begin(size_t segment) noexcept {
+    return segment_size(segment) - segment_size(0);
+  }
+
+  // Shifts before adding, so that indices near the top of `size_t` don't wrap around
+  static constexpr size_t segment_of(size_t index) noexcept {
+    return std::bit_width((index >> first_segment_bits) + 1) - 1;
+  }
+
+  static constexpr size_t offset_of(size_t index) noexcept {
+    return index - segment_begin(segment_of(index));
+  }
+
+  // Indices at and above it would need one more segment than `max_segment_count`
+  static constexpr size_t max_size() noexcept {
+    return segment_begin(max_segment_count - 1) + segment_size(max_segment_count - 1);
+  }
+};
+
+} // namespace detail
@@ -0,0 +1,452 @@
+#pragma once
+
+#include "segment-layout.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Vector that grows by allocating segments of growing powers of two instead of reallocating, so elements are
+// never moved by insertions at the end: references, pointers and iterators stay valid across `push_back`, and
+// growing a large vector never copies its whole contents. The elements are not contiguous, so there is no `data()`.
+// Iterators refer to the vector itself and an index, they are invalidated by moving or swapping the vector
+template <typename T, typename Allocator = std::allocator<T>>
+class segmented_vector {
+  using alloc_traits = std::allocator_traits<Allocator>;
+  using segments_type = vector<T*, typename alloc_traits::template rebind_alloc<T*>>;
+
+  using layout = detail::segment_layout;
+
+  template <bool Const>
+  class basic_iterator {
+    using container = std::conditional_t<Const, const segmented_vector, segmented_vector>;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<Const, const T&, T&>;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+
+    basic_iterator() noexcept = default;
+
+    // O(1) nothrow
+    operator basic_iterator<true>() const noexcept {
+      return basic_iterator<true>(owner_, index_);
+    }
+
+    reference operator*() const noexcept {
+      return (*owner_)[index_];
+    }
+
+    pointer operator->() const noexcept {
+      return &**this;
+    }
+
+    reference operator[](difference_type n) const noexcept {
+      return (*owner_)[index_ + n];
+    }
+
+    basic_iterator& operator++() noexcept {
+      ++index_;
+      return *this;
+    }
+
+    basic_iterator operator++(int) noexcept {
+      basic_iterator result = *this;
+      ++*this;
+      return result;
+    }
+
+    basic_iterator& operator--() noexcept {
+      --index_;
+      return *this;
+    }
+
+    basic_iterator operator--(int) noexcept {
+      basic_iterator result = *this;
+      --*this;
+      return result;
+    }
+
+    basic_iterator& operator+=(difference_type n) noexcept {
+      index_ += n;
+      return *this;
+    }
+
+    basic_iterator& operator-=(difference_type n) noexcept {
+      index_ -= n;
+      return *this;
+    }
+
+    friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept {
+      return it += n;
+    }
+
+    friend basic_iterator operator+(difference_type n, basic_iterator it) noexcept {
+      return it += n;
+    }
+
+    friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept {
+      return it -= n;
+    }
+
+    friend difference_type operator-(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+      return static_cast<difference_type>(lhs.index_ - rhs.index_);
+    }
+
+    friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+      return lhs.index_ == rhs.index_;
+    }
+
+    friend std::strong_ordering operator<=>(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+      return lhs.index_ <=> rhs.index_;
+    }
+
+  private:
+    basic_iterator(container* owner, size_t index) noexcept
+        : owner_(owner)
+        , index_(index) {}
+
+    friend segmented_vector;
+
+  private:
+    container* owner_ = nullptr;
+    size_t index_ = 0;
+  };
+
+public:
+  using value_type = T;
+  using allocator_type = Allocator;
+
+  using reference = T&;
+  using const_reference = const T&;
+
+  using pointer = T*;
+  using const_pointer = const T*;
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  // O(1) nothrow
+  segmented_vector() noexcept(std::is_nothrow_default_constructible_v<Allocator>) = default;
+
+  // O(1) nothrow
+  explicit segmented_vector(const Allocator& alloc) noexcept
+      : alloc_(alloc)
+      , segments_(alloc) {}
+
+  // O(N) strong
+  segmented_vector(std::initializer_list<T> values, const Allocator& alloc = Allocator())
+      : segmented_vector(alloc) {
+    append(values.begin(), values.size());
+  }
+
+  // O(N) strong
+  segmented_vector(const segmented_vector& other)
+      : segmented_vector(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+    append(other.begin(), other.size());
+  }
+
+  // O(1) nothrow
+  segmented_vector(segmented_vector&& other) noexcept
+      : alloc_(other.alloc_)
+      , segments_(std::move(other.segments_))
+      , size_(std::exchange(other.size_, 0)) {}
+
+  // O(N) strong
+  segmented_vector& operator=(const segmented_vector& other) {
+    if (this != &other) {
+      segmented_vector copy(alloc_traits::propagate_on_container_copy_assignment::value ? other.alloc_ : alloc_);
+      copy.append(other.begin(), other.size());
+      release_segments();
+      if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+        alloc_ = copy.alloc_;
+      }
+      steal(copy);
+    }
+    return *this;
+  }
+
+  // O(1) nothrow if allocators propagate or are equal, O(N) strong otherwise
+  segmented_vector& operator=(segmented_vector&& other) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value
+  ) {
+    if (this == &other) {
+      return *this;
+    }
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+      release_segments();
+      alloc_ = other.alloc_;
+      steal(other);
+    } else if (alloc_traits::is_always_equal::value || alloc_ == other.alloc_) {
+      release_segments();
+      steal(other);
+    } else {
+      segmented_vector copy(alloc_);
+      copy.append(std::make_move_iterator(other.begin()), other.size());
+      release_segments();
+      steal(copy);
+    }
+    return *this;
+  }
+
+  // O(N) nothrow
+  ~segmented_vector() noexcept {
+    clear();
+    deallocate_segments(0);
+  }
+
+  // O(1) nothrow
+  allocator_type get_allocator() const noexcept {
+    return alloc_;
+  }
+
+  // O(1) nothrow
+  reference operator[](size_t index) {
+    return segments_[layout::segment_of(index)][layout::offset_of(index)];
+  }
+
+  // O(1) nothrow
+  const_reference operator[](size_t index) const {
+    return segments_[layout::segment_of(index)][layout::offset_of(index)];
+  }
+
+  // O(1) nothrow
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  // O(1) nothrow
+  reference front() {
+    return (*this)[0];
+  }
+
+  // O(1) nothrow
+  const_reference front() const {
+    return (*this)[0];
+  }
+
+  // O(1) nothrow
+  reference back() {
+    return (*this)[size_ - 1];
+  }
+
+  // O(1) nothrow
+  const_reference back() const {
+    return (*this)[size_ - 1];
+  }
+
+  // O(1) strong, never moves the elements
+  void push_back(const T& value) {
+    emplace_back(value);
+  }
+
+  // O(1) strong, never moves the elements
+  void push_back(T&& value) {
+    emplace_back(std::move(value));
+  }
+
+  // O(1) strong, never moves the elements
+  template <typename... Args>
+  reference emplace_back(Args&&... args) {
+    if (size_ == capacity()) {
+      add_segment();
+    }
+    T* slot = &(*this)[size_];
+    alloc_traits::construct(alloc_, slot, std::forward<Args>(args)...);
+    ++size_;
+    return *slot;
+  }
+
+  // O(1) nothrow
+  void pop_back() {
+    --size_;
+    alloc_traits::destroy(alloc_, &(*this)[size_]);
+  }
+
+  // O(1) nothrow
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  // O(1) nothrow
+  size_t capacity() const noexcept {
+    return layout::segment_begin(segments_.size());
+  }
+
+  // O(log N) strong, allocates segments without touching the elements
+  void reserve(size_t new_capacity) {
+    while (capacity() < new_capacity) {
+      add_segment();
+    }
+  }
+
+  // O(log N) nothrow, frees the segments that contain no elements
+  void shrink_to_fit() noexcept {
+    size_t used = 0;
+    while (layout::segment_begin(used) < size_) {
+      ++used;
+    }
+    deallocate_segments(used);
+  }
+
+  // O(N) strong
+  void resize(size_t count)
+    requires std::default_initializable<T>
+  {
+    resize_with(count, [this] { emplace_back(); });
+  }
+
+  // O(N) strong
+  void resize(size_t count, const T& value) {
+    resize_with(count, [&] { emplace_back(value); });
+  }
+
+  // O(N) nothrow, keeps the segments
+  void clear() noexcept {
+    while (size_ != 0) {
+      pop_back();
+    }
+  }
+
+  // O(1) nothrow, the allocators are swapped if they propagate on swap, and must be equal otherwise
+  void swap(segmented_vector& other) noexcept {
+    using std::swap;
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+      swap(alloc_, other.alloc_);
+    } else {
+      detail::check(alloc_ == other.alloc_, "swapping vectors with unequal allocators");
+    }
+    segments_.swap(other.segments_);
+    swap(size_, other.size_);
+  }
+
+  // O(1) nothrow
+  friend void swap(segmented_vector& lhs, segmented_vector& rhs) noexcept {
+    lhs.swap(rhs);
+  }
+
+  // O(1) nothrow
+  iterator begin() noexcept {
+    return iterator(this, 0);
+  }
+
+  // O(1) nothrow
+  iterator end() noexcept {
+    return iterator(this, size_);
+  }
+
+  // O(1) nothrow
+  const_iterator begin() const noexcept {
+    return const_iterator(this, 0);
+  }
+
+  // O(1) nothrow
+  const_iterator end() const noexcept {
+    return const_iterator(this, size_);
+  }
+
+  // O(N) strong if swap doesn't throw, basic otherwise
+  iterator insert(const_iterator pos, const T& value) {
+    return emplace(pos, value);
+  }
+
+  // O(N) strong if swap doesn't throw, basic otherwise
+  iterator insert(const_iterator pos, T&& value) {
+    return emplace(pos, std::move(value));
+  }
+
+  // O(N) strong if swap doesn't throw, basic otherwise. Elements after `pos` are shifted in place
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args) {
+    size_t index = pos.index_;
+    emplace_back(std::forward<Args>(args)...);
+    std::rotate(begin() + index, end() - 1, end());
+    return begin() + index;
+  }
+
+  // O(N) nothrow(move)
+  iterator erase(const_iterator pos) {
+    return erase(pos, pos + 1);
+  }
+
+  // O(N) nothrow(move)
+  iterator erase(const_iterator first, const_iterator last) {
+    size_t index = first.index_;
+    size_t count = last.index_ - first.index_;
+    std::move(begin() + last.index_, end(), begin() + index);
+    for (size_t i = 0; i != count; ++i) {
+      pop_back();
+    }
+    return begin() + index;
+  }
+
+private:
+  // Destroys the elements and frees all the segments
+  void release_segments() noexcept {
+    clear();
+    deallocate_segments(0);
+  }
+
+  // Takes the elements of `other`, leaving it empty. `*this` must own no segments, and its allocator must be equal
+  // to the one of `other`
+  void steal(segmented_vector& other) noexcept {
+    segments_ = std::move(other.segments_);
+    size_ = std::exchange(other.size_, 0);
+  }
+
+  // The slot for the pointer is reserved first, so that the new segment can't leak
+  void add_segment() {
+    segments_.reserve(segments_.size() + 1);
+    segments_.push_back(alloc_traits::allocate(alloc_, layout::segment_size(segments_.size())));
+  }
+
+  void deallocate_segments(size_t keep) noexcept {
+    while (segments_.size() > keep) {
+      alloc_traits::deallocate(alloc_, segments_.back(), layout::segment_size(segments_.size() - 1));
+      segments_.pop_back();
+    }
+  }
+
+  template <typename It>
+  void append(It first, size_t count) {
+    reserve(count);
+    for (size_t i = 0; i != count; ++i, ++first) {
+      emplace_back(*first);
+    }
+  }
+
+  template <typename Construct>
+  void resize_with(size_t count, Construct construct) {
+    size_t old_size = size_;
+    if (count <= old_size) {
+      while (size_ != count) {
+        pop_back();
+      }
+      return;
+    }
+    reserve(count);
+    try {
+      while (size_ != count) {
+        construct();
+      }
+    } catch (...) {
+      while (size_ != old_size) {
+        pop_back();
+      }
+      throw;
+    }
+  }
+
+private:
+  [[no_unique_address]] Allocator alloc_;
+  segments_type segments_;
+  size_t size_ = 0;
+};
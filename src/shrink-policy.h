@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+// Shrink policies clear a vector that is refilled on every cycle of a batch loop. Keeping the capacity between
+// cycles makes the steady state allocation-free, trimming it bounds the memory kept after a single large batch.
+// A policy provides `void reset(Vector& v)`, which destroys the elements and may reduce the capacity.
+
+// Never trims, `reset` is `clear`
+struct keep_capacity {
+  // O(N) nothrow
+  template <typename Vector>
+  static void reset(Vector& v) noexcept {
+    v.clear();
+  }
+};
+
+// Trims the capacity to the largest size of the last `Cycles` cycles once all of them have used less than
+// `1 / Divisor` of it. A cycle that uses more starts the count over, so a vector that is regularly filled to
+// its capacity never reallocates
+template <size_t Cycles = 8, size_t Divisor = 4>
+class high_water_mark_shrink {
+  static_assert(Cycles > 0 && Divisor > 0);
+
+public:
+  // O(N) basic, the vector is empty even if trimming throws. Allocates only when trimming
+  template <typename Vector>
+  void reset(Vector& v) {
+    size_t size = v.size();
+    v.clear();
+    if (size * Divisor >= v.capacity()) {
+      underused_cycles_ = 0;
+      high_water_mark_ = 0;
+      return;
+    }
+    high_water_mark_ = std::max(high_water_mark_, size);
+    if (++underused_cycles_ == Cycles) {
+      size_t new_capacity = high_water_mark_;
+      underused_cycles_ = 0;
+      high_water_mark_ = 0;
+      v.shrink_to(new_capacity);
+    }
+  }
+
+  // O(1) nothrow, the number of consecutive underused cycles so far
+  size_t underused_cycles() const noexcept {
+    return underused_cycles_;
+  }
+
+private:
+  size_t underused_cycles_ = 0;
+  size_t high_water_mark_ = 0;
+};
@@ -0,0 +1,378 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+// Search and comparison kernels for contiguous arrays of arithmetic elements. On x86-64 the widest of AVX-512,
+// AVX2 and SSE2 available on the processor is selected once at runtime, AArch64 always has NEON. Other compilers
+// and platforms use the scalar loops. The kernels are written with GCC vector extensions, so a single body is
+// compiled for every register width
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__aarch64__))
+#define VECTOR_SIMD_KERNELS 1
+#endif
+
+namespace detail::simd {
+
+// Element types handled by the kernels, other types use the scalar loops
+template <typename T>
+inline constexpr bool is_supported = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+                                     (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+// Register width in bytes, 0 means the scalar loops
+inline size_t detect_width() noexcept {
+#if defined(VECTOR_SIMD_KERNELS) && defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512bw")) {
+    return 64;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return 32;
+  }
+  return 16;
+#elif defined(VECTOR_SIMD_KERNELS)
+  return 16;
+#else
+  return 0;
+#endif
+}
+
+inline size_t width() noexcept {
+  static const size_t result = detect_width();
+  return result;
+}
+
+template <typename T>
+size_t find_scalar(const T* data, size_t count, T value) noexcept {
+  return std::find(data, data + count, value) - data;
+}
+
+template <typename T>
+size_t count_scalar(const T* data, size_t count, T value) noexcept {
+  return std::count(data, data + count, value);
+}
+
+template <typename T>
+size_t mismatch_scalar(const T* lhs, const T* rhs, size_t count) noexcept {
+  return std::mismatch(lhs, lhs + count, rhs).first - lhs;
+}
+
+template <typename T>
+size_t min_scalar(const T* data, size_t count) noexcept {
+  return std::min_element(data, data + count) - data;
+}
+
+template <typename T>
+size_t max_scalar(const T* data, size_t count) noexcept {
+  return std::max_element(data, data + count) - data;
+}
+
+#ifdef VECTOR_SIMD_KERNELS
+
+template <typename T, size_t Width>
+struct lanes {
+  static_assert(is_supported<T>);
+
+  using mask_element = std::conditional_t<
+      sizeof(T) == 1, int8_t,
+      std::conditional_t<sizeof(T) == 2, int16_t, std::conditional_t<sizeof(T) == 4, int32_t, int64_t>>>;
+
+  typedef T value __attribute__((vector_size(Width)));
+  typedef mask_element mask __attribute__((vector_size(Width)));
+
+  static constexpr size_t count = Width / sizeof(T);
+};
+
+// Number of elements in a cache line, the unit of the main loops
+template <typename T>
+inline constexpr size_t line_lanes = 64 / sizeof(T);
+
+// Vectors are passed by reference, passing them by value in functions compiled for the baseline target would
+// use a different ABI
+template <typename V, typename T>
+[[gnu::always_inline]] inline void load(V& result, const T* data) noexcept {
+  std::memcpy(&result, data, sizeof(V));
+}
+
+template <size_t Width>
+struct words {
+  typedef int64_t type __attribute__((vector_size(Width)));
+};
+
+// Folds the halves of the mask together down to 16 bytes, which keeps the reduction in vector registers
+template <typename M>
+[[gnu::always_inline]] inline bool any_set(const M& mask) noexcept {
+  if constexpr (sizeof(M) > 16) {
+    using half = typename words<sizeof(M) / 2>::type;
+    half low, high;
+    std::memcpy(&low, &mask, sizeof(half));
+    std::memcpy(&high, reinterpret_cast<const std::byte*>(&mask) + sizeof(half), sizeof(half));
+    half folded = low | high;
+    return any_set(folded);
+  } else {
+    uint64_t halves[2];
+    std::memcpy(halves, &mask, sizeof(M));
+    return (halves[0] | halves[1]) != 0;
+  }
+}
+
+template <size_t Width, typename T>
+[[gnu::always_inline]] inline size_t find_kernel(const T* data, size_t count, T value) noexcept {
+  using L = lanes<T, Width>;
+  typename L::value needle = typename L::value{} + value;
+  size_t i = 0;
+  // A cache line is compared per test of the masks. Combining 512-bit masks with `|` is scalarized by GCC,
+  // which is avoided by the single register per line at that width
+  for (; i + line_lanes<T> <= count; i += line_lanes<T>) {
+    typename L::value chunk;
+    load(chunk, data + i);
+    auto found = chunk == needle;
+    for (size_t j = L::count; j != line_lanes<T>; j += L::count) {
+      load(chunk, data + i + j);
+      found |= chunk == needle;
+    }
+    if (any_set(found)) {
+      break;
+    }
+  }
+  for (; i + L::count <= count; i += L::count) {
+    typename L::value chunk;
+    load(chunk, data + i);
+    if (any_set(chunk == needle)) {
+      break;
+    }
+  }
+  return i + find_scalar(data + i, count - i, value);
+}
+
+template <size_t Width, typename T>
+[[gnu::always_inline]] inline size_t count_kernel(const T* data, size_t count, T value) noexcept {
+  using L = lanes<T, Width>;
+  // Each mask lane is -1 for a match, the lanes are summed before they can overflow
+  constexpr size_t block = std::min<size_t>(std::numeric_limits<typename L::mask_element>::max(), size_t(1) << 20);
+  typename L::value needle = typename L::value{} + value;
+  size_t result = 0;
+  size_t i = 0;
+  while (i + L::count <= count) {
+    typename L::mask sum = {};
+    for (size_t j = 0; j != block && i + L::count <= count; ++j, i += L::count) {
+      typename L::value chunk;
+      load(chunk, data + i);
+      sum -= chunk == needle;
+    }
+    for (size_t lane = 0; lane != L::count; ++lane) {
+      result += static_cast<size_t>(sum[lane]);
+    }
+  }
+  return result + count_scalar(data + i, count - i, value);
+}
+
+template <size_t Width, typename T>
+[[gnu::always_inline]] inline size_t mismatch_kernel(const T* lhs, const T* rhs, size_t count) noexcept {
+  using L = lanes<T, Width>;
+  size_t i = 0;
+  for (; i + line_lanes<T> <= count; i += line_lanes<T>) {
+    typename L::value a, b;
+    load(a, lhs + i);
+    load(b, rhs + i);
+    auto different = a != b;
+    for (size_t j = L::count; j != line_lanes<T>; j += L::count) {
+      load(a, lhs + i + j);
+      load(b, rhs + i + j);
+      different |= a != b;
+    }
+    if (any_set(different)) {
+      break;
+    }
+  }
+  for (; i + L::count <= count; i += L::count) {
+    typename L::value a, b;
+    load(a, lhs + i);
+    load(b, rhs + i);
+    if (any_set(a != b)) {
+      break;
+    }
+  }
+  return i + mismatch_scalar(lhs + i, rhs + i, count - i);
+}
+
+// Finds the smallest (or the largest if `Max`) value with a vector of running extremes, and then its first
+// position. Only for integers, floating-point elements may be NaN
+template <size_t Width, bool Max, typename T>
+[[gnu::always_inline]] inline size_t extremum_kernel(const T* data, size_t count) noexcept {
+  using L = lanes<T, Width>;
+  if (count < L::count) {
+    return Max ? max_scalar(data, count) : min_scalar(data, count);
+  }
+  typename L::value best;
+  load(best, data);
+  size_t i = L::count;
+  for (; i + L::count <= count; i += L::count) {
+    typename L::value chunk;
+    load(chunk, data + i);
+    best = (Max ? chunk > best : chunk < best) ? chunk : best;
+  }
+  T result = best[0];
+  for (size_t lane = 1; lane != L::count; ++lane) {
+    result = Max ? std::max<T>(result, best[lane]) : std::min<T>(result, best[lane]);
+  }
+  for (; i != count; ++i) {
+    result = Max ? std::max(result, data[i]) : std::min(result, data[i]);
+  }
+  return find_kernel<Width>(data, count, result);
+}
+
+#ifdef __x86_64__
+
+template <typename T>
+[[gnu::target("avx2")]] size_t find_avx2(const T* data, size_t count, T value) noexcept {
+  return find_kernel<32>(data, count, value);
+}
+
+template <typename T>
+[[gnu::target("avx2")]] size_t count_avx2(const T* data, size_t count, T value) noexcept {
+  return count_kernel<32>(data, count, value);
+}
+
+template <typename T>
+[[gnu::target("avx2")]] size_t mismatch_avx2(const T* lhs, const T* rhs, size_t count) noexcept {
+  return mismatch_kernel<32>(lhs, rhs, count);
+}
+
+template <bool Max, typename T>
+[[gnu::target("avx2")]] size_t extremum_avx2(const T* data, size_t count) noexcept {
+  return extremum_kernel<32, Max>(data, count);
+}
+
+template <typename T>
+[[gnu::target("avx512f,avx512bw,avx512dq,avx512vl")]] size_t find_avx512(
+    const T* data,
+    size_t count,
+    T value
+) noexcept {
+  return find_kernel<64>(data, count, value);
+}
+
+template <typename T>
+[[gnu::target("avx512f,avx512bw,avx512dq,avx512vl")]] size_t count_avx512(
+    const T* data,
+    size_t count,
+    T value
+) noexcept {
+  return count_kernel<64>(data, count, value);
+}
+
+template <typename T>
+[[gnu::target("avx512f,avx512bw,avx512dq,avx512vl")]] size_t mismatch_avx512(
+    const T* lhs,
+    const T* rhs,
+    size_t count
+) noexcept {
+  return mismatch_kernel<64>(lhs, rhs, count);
+}
+
+template <bool Max, typename T>
+[[gnu::target("avx512f,avx512bw,avx512dq,avx512vl")]] size_t extremum_avx512(const T* data, size_t count) noexcept {
+  return extremum_kernel<64, Max>(data, count);
+}
+
+#endif
+
+#endif
+
+// The functions below take the register width explicitly, so that every kernel can be tested on
+// the processor that runs the tests. `width` must not exceed `simd::width()`
+
+// Index of the first element equal to `value`, or `count`
+template <typename T>
+size_t find(const T* data, size_t count, T value, [[maybe_unused]] size_t width = simd::width()) noexcept {
+#ifdef VECTOR_SIMD_KERNELS
+#ifdef __x86_64__
+  if (width == 64) {
+    return find_avx512(data, count, value);
+  }
+  if (width == 32) {
+    return find_avx2(data, count, value);
+  }
+#endif
+  if (width != 0) {
+    return find_kernel<16>(data, count, value);
+  }
+#endif
+  return find_scalar(data, count, value);
+}
+
+// Number of elements equal to `value`
+template <typename T>
+size_t count(const T* data, size_t count, T value, [[maybe_unused]] size_t width = simd::width()) noexcept {
+#ifdef VECTOR_SIMD_KERNELS
+#ifdef __x86_64__
+  if (width == 64) {
+    return count_avx512(data, count, value);
+  }
+  if (width == 32) {
+    return count_avx2(data, count, value);
+  }
+#endif
+  if (width != 0) {
+    return count_kernel<16>(data, count, value);
+  }
+#endif
+  return count_scalar(data, count, value);
+}
+
+// Index of the first position where the arrays differ, or `count`
+template <typename T>
+size_t mismatch(const T* lhs, const T* rhs, size_t count, [[maybe_unused]] size_t width = simd::width()) noexcept {
+#ifdef VECTOR_SIMD_KERNELS
+#ifdef __x86_64__
+  if (width == 64) {
+    return mismatch_avx512(lhs, rhs, count);
+  }
+  if (width == 32) {
+    return mismatch_avx2(lhs, rhs, count);
+  }
+#endif
+  if (width != 0) {
+    return mismatch_kernel<16>(lhs, rhs, count);
+  }
+#endif
+  return mismatch_scalar(lhs, rhs, count);
+}
+
+// Whether the arrays are equal. Integers are compared bytewise
+template <typename T>
+bool equal(const T* lhs, const T* rhs, size_t count, [[maybe_unused]] size_t width = simd::width()) noexcept {
+  if constexpr (std::is_integral_v<T>) {
+    return count == 0 || std::memcmp(lhs, rhs, count * sizeof(T)) == 0;
+  } else {
+    return mismatch(lhs, rhs, count, width) == count;
+  }
+}
+
+// Index of the first smallest (or largest if `Max`) element, or `count` if there are none
+template <bool Max, typename T>
+size_t extremum(const T* data, size_t count, [[maybe_unused]] size_t width = simd::width()) noexcept {
+  if constexpr (std::is_integral_v<T>) {
+#ifdef VECTOR_SIMD_KERNELS
+#ifdef __x86_64__
+    if (width == 64) {
+      return extremum_avx512<Max>(data, count);
+    }
+    if (width == 32) {
+      return extremum_avx2<Max>(data, count);
+    }
+#endif
+    if (width != 0) {
+      return extremum_kernel<16, Max>(data, count);
+    }
+#endif
+  }
+  return Max ? max_scalar(data, count) : min_scalar(data, count);
+}
+
+} // namespace detail::simd
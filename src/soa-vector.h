@@ -0,0 +1,544 @@
+#pragma once
+
+#include "aligned-vector.h"
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Vector of tuples that stores each field in its own contiguous column, so scanning one field only reads that
+// field. All the columns share a single allocation, size and capacity, and grow together; every column starts
+// at a cache line boundary. Elements are accessed as tuples of references, e.g. `auto [x, y] = v[i];`
+template <typename... Ts>
+class soa_vector {
+  static_assert(sizeof...(Ts) != 0, "soa_vector requires at least one column");
+
+  static constexpr size_t column_count = sizeof...(Ts);
+  static constexpr size_t column_alignment = std::max({size_t(64), alignof(Ts)...});
+  static constexpr size_t column_sizes[] = {sizeof(Ts)...};
+  static constexpr size_t element_size = (sizeof(Ts) + ...);
+
+  using byte_allocator = aligned_allocator<std::byte, column_alignment>;
+
+  template <bool Const>
+  class basic_iterator {
+    using container = std::conditional_t<Const, const soa_vector, soa_vector>;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::tuple<Ts...>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<Const, std::tuple<const Ts&...>, std::tuple<Ts&...>>;
+    using pointer = void;
+
+    basic_iterator() noexcept = default;
+
+    // O(1) nothrow
+    operator basic_iterator<true>() const noexcept {
+      return basic_iterator<true>(owner_, index_);
+    }
+
+    reference operator*() const noexcept {
+      return (*owner_)[index_];
+    }
+
+    reference operator[](difference_type n) const noexcept {
+      return (*owner_)[index_ + n];
+    }
+
+    basic_iterator& operator++() noexcept {
+      ++index_;
+      return *this;
+    }
+
+    basic_iterator operator++(int) noexcept {
+      basic_iterator result = *this;
+      ++*this;
+      return result;
+    }
+
+    basic_iterator& operator--() noexcept {
+      --index_;
+      return *this;
+    }
+
+    basic_iterator operator--(int) noexcept {
+      basic_iterator result = *this;
+      --*this;
+      return result;
+    }
+
+    basic_iterator& operator+=(difference_type n) noexcept {
+      index_ += n;
+      return *this;
+    }
+
+    basic_iterator& operator-=(difference_type n) noexcept {
+      index_ -= n;
+      return *this;
+    }
+
+    friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept {
+      return it += n;
+    }
+
+    friend basic_iterator operator+(difference_type n, basic_iterator it) noexcept {
+      return it += n;
+    }
+
+    friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept {
+      return it -= n;
+    }
+
+    friend difference_type operator-(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+      return static_cast<difference_type>(lhs.index_ - rhs.index_);
+    }
+
+    friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+      return lhs.index_ == rhs.index_;
+    }
+
+    friend std::strong_ordering operator<=>(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+      return lhs.index_ <=> rhs.index_;
+    }
+
+  private:
+    basic_iterator(container* owner, size_t index) noexcept
+        : owner_(owner)
+        , index_(index) {}
+
+    friend soa_vector;
+
+  private:
+    container* owner_ = nullptr;
+    size_t index_ = 0;
+  };
+
+public:
+  template <size_t I>
+  using column_type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+  using value_type = std::tuple<Ts...>;
+
+  using reference = std::tuple<Ts&...>;
+  using const_reference = std::tuple<const Ts&...>;
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  // O(1) nothrow
+  soa_vector() noexcept = default;
+
+  // O(N) strong
+  soa_vector(const soa_vector& other) {
+    if (other.size_ == 0) {
+      return;
+    }
+    std::byte* new_data = allocate(other.size_);
+    try {
+      for_each_column_strong(
+          [&](auto column) {
+            constexpr size_t I = decltype(column)::value;
+            std::uninitialized_copy_n(
+                other.template column_data<I>(),
+                other.size_,
+                column_at<I>(new_data, other.size_)
+            );
+          },
+          [&](auto column) {
+            constexpr size_t I = decltype(column)::value;
+            std::destroy_n(column_at<I>(new_data, other.size_), other.size_);
+          });
+    } catch (...) {
+      deallocate(new_data, other.size_);
+      throw;
+    }
+    data_ = new_data;
+    size_ = other.size_;
+    capacity_ = other.size_;
+  }
+
+  // O(1) nothrow
+  soa_vector(soa_vector&& other) noexcept
+      : data_(std::exchange(other.data_, nullptr))
+      , size_(std::exchange(other.size_, 0))
+      , capacity_(std::exchange(other.capacity_, 0)) {}
+
+  // O(N) strong
+  soa_vector& operator=(const soa_vector& other) {
+    if (this != &other) {
+      soa_vector(other).swap(*this);
+    }
+    return *this;
+  }
+
+  // O(1) nothrow
+  soa_vector& operator=(soa_vector&& other) noexcept {
+    if (this != &other) {
+      soa_vector(std::move(other)).swap(*this);
+    }
+    return *this;
+  }
+
+  // O(N) nothrow
+  ~soa_vector() noexcept {
+    clear();
+    deallocate(data_, capacity_);
+  }
+
+  // O(1) nothrow
+  reference operator[](size_t index) {
+    return access(index, std::index_sequence_for<Ts...>());
+  }
+
+  // O(1) nothrow
+  const_reference operator[](size_t index) const {
+    return access(index, std::index_sequence_for<Ts...>());
+  }
+
+  // O(1) nothrow, the elements of column `I`
+  template <size_t I>
+  std::span<column_type<I>> column() noexcept {
+    return {column_data<I>(), size_};
+  }
+
+  // O(1) nothrow
+  template <size_t I>
+  std::span<const column_type<I>> column() const noexcept {
+    return {column_data<I>(), size_};
+  }
+
+  // O(1) nothrow
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  // O(1) nothrow
+  size_t capacity() const noexcept {
+    return capacity_;
+  }
+
+  // O(1) nothrow
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  // O(1) nothrow
+  reference front() {
+    return (*this)[0];
+  }
+
+  // O(1) nothrow
+  const_reference front() const {
+    return (*this)[0];
+  }
+
+  // O(1) nothrow
+  reference back() {
+    return (*this)[size_ - 1];
+  }
+
+  // O(1) nothrow
+  const_reference back() const {
+    return (*this)[size_ - 1];
+  }
+
+  // O(1)* strong
+  void push_back(const Ts&... values) {
+    emplace_back(values...);
+  }
+
+  // O(1)* strong
+  void push_back(Ts&&... values) {
+    emplace_back(std::move(values)...);
+  }
+
+  // O(1)* strong, constructs the field of each column from the corresponding argument
+  template <typename... Args>
+    requires(sizeof...(Args) == column_count && (std::is_constructible_v<Ts, Args &&> && ...))
+  reference emplace_back(Args&&... args) {
+    auto values = std::forward_as_tuple(std::forward<Args>(args)...);
+    if (size_ != capacity_) {
+      construct_at_end(data_, capacity_, values);
+    } else {
+      // The new element is constructed first, as the arguments may refer to the current elements
+      size_t new_capacity = next_capacity(size_ + 1);
+      std::byte* new_data = allocate(new_capacity);
+      try {
+        construct_at_end(new_data, new_capacity, values);
+        try {
+          relocate_to(new_data, new_capacity);
+        } catch (...) {
+          destroy_at(new_data, new_capacity, size_);
+          throw;
+        }
+      } catch (...) {
+        deallocate(new_data, new_capacity);
+        throw;
+      }
+      replace_buffer(new_data, new_capacity);
+    }
+    ++size_;
+    return back();
+  }
+
+  // O(1) nothrow
+  void pop_back() {
+    --size_;
+    destroy_at(data_, capacity_, size_);
+  }
+
+  // O(N) strong
+  void reserve(size_t new_capacity) {
+    if (new_capacity > capacity_) {
+      reallocate(new_capacity);
+    }
+  }
+
+  // O(N) strong
+  void shrink_to_fit() {
+    if (size_ == 0) {
+      deallocate(data_, capacity_);
+      data_ = nullptr;
+      capacity_ = 0;
+    } else if (size_ != capacity_) {
+      reallocate(size_);
+    }
+  }
+
+  // O(N) nothrow, destroys in the reverse order of construction
+  void clear() noexcept {
+    for_each_column_reverse([&](auto column) {
+      constexpr size_t I = decltype(column)::value;
+      column_type<I>* data = column_data<I>();
+      for (size_t i = size_; i > 0; --i) {
+        std::destroy_at(data + i - 1);
+      }
+    });
+    size_ = 0;
+  }
+
+  // O(1) nothrow
+  void swap(soa_vector& other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+  }
+
+  // O(1) nothrow
+  friend void swap(soa_vector& lhs, soa_vector& rhs) noexcept {
+    lhs.swap(rhs);
+  }
+
+  // O(1) nothrow
+  iterator begin() noexcept {
+    return iterator(this, 0);
+  }
+
+  // O(1) nothrow
+  iterator end() noexcept {
+    return iterator(this, size_);
+  }
+
+  // O(1) nothrow
+  const_iterator begin() const noexcept {
+    return const_iterator(this, 0);
+  }
+
+  // O(1) nothrow
+  const_iterator end() const noexcept {
+    return const_iterator(this, size_);
+  }
+
+private:
+  static constexpr size_t round_up(size_t bytes) noexcept {
+    return (bytes + column_alignment - 1) / column_alignment * column_alignment;
+  }
+
+  // Offset of the column `index` in a buffer for `capacity` elements, or the size of the buffer for
+  // `index == column_count`
+  static constexpr size_t column_offset(size_t index, size_t capacity) noexcept {
+    size_t offset = 0;
+    for (size_t i = 0; i != index; ++i) {
+      offset += round_up(capacity * column_sizes[i]);
+    }
+    return offset;
+  }
+
+  template <size_t I>
+  static column_type<I>* column_at(std::byte* buffer, size_t capacity) noexcept {
+    return reinterpret_cast<column_type<I>*>(buffer + column_offset(I, capacity));
+  }
+
+  template <size_t I>
+  column_type<I>* column_data() noexcept {
+    return column_at<I>(data_, capacity_);
+  }
+
+  template <size_t I>
+  const column_type<I>* column_data() const noexcept {
+    return column_at<I>(data_, capacity_);
+  }
+
+  template <size_t... Is>
+  reference access(size_t index, std::index_sequence<Is...>) noexcept {
+    return reference(column_data<Is>()[index]...);
+  }
+
+  template <size_t... Is>
+  const_reference access(size_t index, std::index_sequence<Is...>) const noexcept {
+    return const_reference(column_data<Is>()[index]...);
+  }
+
+  template <typename F, size_t... Is>
+  static void for_each_column(F f, std::index_sequence<Is...>) {
+    (f(std::integral_constant<size_t, Is>()), ...);
+  }
+
+  template <typename F>
+  static void for_each_column(F f) {
+    for_each_column(f, std::index_sequence_for<Ts...>());
+  }
+
+  template <typename F, size_t... Is>
+  static void for_each_column_reverse(F f, std::index_sequence<Is...>) {
+    (f(std::integral_constant<size_t, column_count - 1 - Is>()), ...);
+  }
+
+  template <typename F>
+  static void for_each_column_reverse(F f) {
+    for_each_column_reverse(f, std::index_sequence_for<Ts...>());
+  }
+
+  // Calls `apply(column)` for each column in order. If it throws, calls `undo(column)` for the columns
+  // processed before, in reverse order
+  template <size_t I = 0, typename Apply, typename Undo>
+  static void for_each_column_strong(Apply apply, Undo undo) {
+    if constexpr (I != column_count) {
+      apply(std::integral_constant<size_t, I>());
+      try {
+        for_each_column_strong<I + 1>(apply, undo);
+      } catch (...) {
+        undo(std::integral_constant<size_t, I>());
+        throw;
+      }
+    }
+  }
+
+  static std::byte* allocate(size_t capacity) {
+    size_t max_capacity = (std::numeric_limits<size_t>::max() - column_count * column_alignment) / element_size;
+    if (capacity > max_capacity) {
+      throw std::bad_array_new_length();
+    }
+    return byte_allocator().allocate(column_offset(column_count, capacity));
+  }
+
+  static void deallocate(std::byte* buffer, size_t capacity) noexcept {
+    if (buffer != nullptr) {
+      byte_allocator().deallocate(buffer, column_offset(column_count, capacity));
+    }
+  }
+
+  size_t next_capacity(size_t required) const noexcept {
+    return std::max(required, default_growth::grow(capacity_, required, element_size));
+  }
+
+  template <typename Values>
+  void construct_at_end(std::byte* buffer, size_t capacity, Values& values) {
+    for_each_column_strong(
+        [&](auto column) {
+          constexpr size_t I = decltype(column)::value;
+          std::construct_at(column_at<I>(buffer, capacity) + size_, std::get<I>(std::move(values)));
+        },
+        [&](auto column) {
+          constexpr size_t I = decltype(column)::value;
+          std::destroy_at(column_at<I>(buffer, capacity) + size_);
+        });
+  }
+
+  void destroy_at(std::byte* buffer, size_t capacity, size_t index) noexcept {
+    for_each_column_reverse([&](auto column) {
+      constexpr size_t I = decltype(column)::value;
+      std::destroy_at(column_at<I>(buffer, capacity) + index);
+    });
+  }
+
+  // Columns that are relocated after all the others, once nothing can throw anymore
+  template <typename T>
+  static constexpr bool nothrow_relocatable = is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>;
+
+  // Copies the columns that may throw to the new buffer first, leaving the old buffer intact on exception, then
+  // moves the rest. Trivially relocatable columns are copied bytewise. Columns that can be neither copied nor
+  // moved without throwing are moved, so only the basic guarantee holds for them
+  void relocate_to(std::byte* new_data, size_t new_capacity) {
+    for_each_column_strong(
+        [&](auto column) {
+          constexpr size_t I = decltype(column)::value;
+          using T = column_type<I>;
+          if constexpr (!nothrow_relocatable<T>) {
+            if constexpr (std::is_copy_constructible_v<T>) {
+              std::uninitialized_copy_n(column_data<I>(), size_, column_at<I>(new_data, new_capacity));
+            } else {
+              std::uninitialized_move_n(column_data<I>(), size_, column_at<I>(new_data, new_capacity));
+            }
+          }
+        },
+        [&](auto column) {
+          constexpr size_t I = decltype(column)::value;
+          if constexpr (!nothrow_relocatable<column_type<I>>) {
+            std::destroy_n(column_at<I>(new_data, new_capacity), size_);
+          }
+        });
+    for_each_column([&](auto column) {
+      constexpr size_t I = decltype(column)::value;
+      using T = column_type<I>;
+      T* src = column_data<I>();
+      T* dst = column_at<I>(new_data, new_capacity);
+      if constexpr (is_trivially_relocatable_v<T>) {
+        if (size_ != 0) {
+          std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), size_ * sizeof(T));
+        }
+      } else if constexpr (std::is_nothrow_move_constructible_v<T>) {
+        std::uninitialized_move_n(src, size_, dst);
+      }
+    });
+  }
+
+  // Destroys the relocated elements in the old buffer and switches to the new one
+  void replace_buffer(std::byte* new_data, size_t new_capacity) noexcept {
+    for_each_column([&](auto column) {
+      constexpr size_t I = decltype(column)::value;
+      if constexpr (!is_trivially_relocatable_v<column_type<I>>) {
+        std::destroy_n(column_data<I>(), size_);
+      }
+    });
+    deallocate(data_, capacity_);
+    data_ = new_data;
+    capacity_ = new_capacity;
+  }
+
+  void reallocate(size_t new_capacity) {
+    std::byte* new_data = allocate(new_capacity);
+    try {
+      relocate_to(new_data, new_capacity);
+    } catch (...) {
+      deallocate(new_data, new_capacity);
+      throw;
+    }
+    replace_buffer(new_data, new_capacity);
+  }
+
+private:
+  std::byte* data_ = nullptr;
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+};
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <type_traits>
+
+// Precondition checks enabled for every `vector` instantiation when `VECTOR_CHECKED` is defined (the
+// `USE_VECTOR_CHECKS` CMake option). Element access checks the index, `front`, `back` and `pop_back` check that
+// the vector is not empty, and iterators become `detail::checked_iterator`, which remember the vector and its
+// generation: the generation changes whenever the elements move to another buffer, so an iterator used after a
+// reallocation is reported. Failed checks print a message and abort.
+// Without it iterators are plain pointers and the checks compile to nothing.
+
+namespace detail {
+
+#ifdef VECTOR_CHECKED
+inline constexpr bool checks_enabled = true;
+#else
+inline constexpr bool checks_enabled = false;
+#endif
+
+[[noreturn]] inline void check_failed(const char* message) noexcept {
+  std::fprintf(stderr, "vector: %s\n", message);
+  std::abort();
+}
+
+// Not a constant expression if the check fails, so misuse during constant evaluation doesn't compile
+constexpr void check(bool condition, const char* message) noexcept {
+  if constexpr (checks_enabled) {
+    if (!condition) {
+      check_failed(message);
+    }
+  }
+}
+
+class checked_generation {
+public:
+  constexpr size_t get() const noexcept {
+    return value_;
+  }
+
+  constexpr void advance() noexcept {
+    ++value_;
+  }
+
+private:
+  size_t value_ = 0;
+};
+
+struct no_generation {
+  constexpr size_t get() const noexcept {
+    return 0;
+  }
+
+  constexpr void advance() noexcept {}
+};
+
+using generation_storage = std::conditional_t<checks_enabled, checked_generation, no_generation>;
+
+// Iterator over the elements of `Owner`, which must provide `data_`, `size_` and `generation_` and befriend it.
+// Iterators refer to the vector object, so they must not be used after it is moved from or swapped
+template <typename T, typename Owner>
+class checked_iterator {
+public:
+  using iterator_concept = std::contiguous_iterator_tag;
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_cv_t<T>;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using pointer = T*;
+
+  constexpr checked_iterator() noexcept = default;
+
+  // O(1) nothrow
+  constexpr operator checked_iterator<const T, Owner>() const noexcept
+    requires (!std::is_const_v<T>)
+  {
+    return checked_iterator<const T, Owner>(ptr_, owner_, generation_);
+  }
+
+  constexpr reference operator*() const noexcept {
+    check_valid();
+    check(ptr_ != owner_->data_ + owner_->size_, "dereferencing the end iterator");
+    return *ptr_;
+  }
+
+  constexpr pointer operator->() const noexcept {
+    check_valid();
+    return ptr_;
+  }
+
+  constexpr reference operator[](difference_type n) const noexcept {
+    return *(*this + n);
+  }
+
+  constexpr checked_iterator& operator++() noexcept {
+    return *this += 1;
+  }
+
+  constexpr checked_iterator operator++(int) noexcept {
+    checked_iterator result = *this;
+    ++*this;
+    return result;
+  }
+
+  constexpr checked_iterator& operator--() noexcept {
+    return *this -= 1;
+  }
+
+  constexpr checked_iterator operator--(int) noexcept {
+    checked_iterator result = *this;
+    --*this;
+    return result;
+  }
+
+  constexpr checked_iterator& operator+=(difference_type n) noexcept {
+    check_valid();
+    difference_type offset = ptr_ - owner_->data_;
+    check(offset + n >= 0 && size_t(offset + n) <= owner_->size_, "iterator moved out of range");
+    ptr_ += n;
+    return *this;
+  }
+
+  constexpr checked_iterator& operator-=(difference_type n) noexcept {
+    return *this += -n;
+  }
+
+  friend constexpr checked_iterator operator+(checked_iterator it, difference_type n) noexcept {
+    return it += n;
+  }
+
+  friend constexpr checked_iterator operator+(difference_type n, checked_iterator it) noexcept {
+    return it += n;
+  }
+
+  friend constexpr checked_iterator operator-(checked_iterator it, difference_type n) noexcept {
+    return it -= n;
+  }
+
+  friend constexpr difference_type operator-(const checked_iterator& lhs, const checked_iterator& rhs) noexcept {
+    check_comparable(lhs, rhs);
+    return lhs.ptr_ - rhs.ptr_;
+  }
+
+  friend constexpr bool operator==(const checked_iterator& lhs, const checked_iterator& rhs) noexcept {
+    check_comparable(lhs, rhs);
+    return lhs.ptr_ == rhs.ptr_;
+  }
+
+  friend constexpr std::strong_ordering operator<=>(const checked_iterator& lhs, const checked_iterator& rhs) noexcept {
+    check_comparable(lhs, rhs);
+    return std::compare_three_way()(lhs.ptr_, rhs.ptr_);
+  }
+
+private:
+  constexpr checked_iterator(T* ptr, const Owner* owner, size_t generation) noexcept
+      : ptr_(ptr)
+      , owner_(owner)
+      , generation_(generation) {}
+
+  constexpr void check_valid() const noexcept {
+    check(owner_ != nullptr, "using a singular iterator");
+    check(generation_ == owner_->generation_.get(), "using an iterator invalidated by reallocation");
+  }
+
+  static constexpr void check_comparable(const checked_iterator& lhs, const checked_iterator& rhs) noexcept {
+    check(lhs.owner_ == rhs.owner_, "comparing iterators of different vectors");
+    if (lhs.owner_ != nullptr) {
+      lhs.check_valid();
+      rhs.check_valid();
+    }
+  }
+
+  friend Owner;
+  friend checked_iterator<std::remove_const_t<T>, Owner>;
+
+private:
+  T* ptr_ = nullptr;
+  const Owner* owner_ = nullptr;
+  size_t generation_ = 0;
+};
+
+} // namespace detail
@@ -0,0 +1,275 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <system_error>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+// Binary format of a vector of trivially copyable elements: a fixed-size header followed by the raw bytes of
+// `data()`. Arithmetic elements written on a machine with the other byte order are swapped when read, other
+// element types are rejected.
+
+namespace detail {
+
+struct vector_io_header {
+  static constexpr uint32_t expected_magic = 0x31434556; // "VEC1"
+  static constexpr uint32_t native_byte_order = 0x01020304;
+  static constexpr uint32_t swapped_byte_order = 0x04030201;
+
+  uint32_t magic = expected_magic;
+  uint32_t byte_order = native_byte_order;
+  uint32_t element_size = 0;
+  uint32_t reserved = 0;
+  uint64_t size = 0;
+};
+
+static_assert(sizeof(vector_io_header) == 24);
+
+template <typename T>
+void byteswap_each(T* data, size_t count) noexcept {
+  for (size_t i = 0; i != count; ++i) {
+    auto* bytes = reinterpret_cast<std::byte*>(data + i);
+    std::reverse(bytes, bytes + sizeof(T));
+  }
+}
+
+// Checks that the header describes a vector of `T`, and sets `swapped` if its elements have to be byte-swapped
+template <typename T>
+bool check_header(vector_io_header& header, bool& swapped) noexcept {
+  swapped = header.byte_order == vector_io_header::swapped_byte_order;
+  if (swapped) {
+    byteswap_each(&header.magic, 1);
+    byteswap_each(&header.element_size, 1);
+    byteswap_each(&header.size, 1);
+  }
+  return header.magic == vector_io_header::expected_magic &&
+         (swapped || header.byte_order == vector_io_header::native_byte_order) &&
+         header.element_size == sizeof(T) && (!swapped || std::is_arithmetic_v<T>) &&
+         header.size <= std::numeric_limits<size_t>::max() / sizeof(T);
+}
+
+// Bytes read at once when the length of the input is unknown, so that the buffer only grows as far as the
+// input actually goes, whatever size the header claims
+inline constexpr size_t read_chunk_bytes = size_t(1) << 20;
+
+// Reads `count` elements into empty `v` with `read(dst, bytes)`, which returns `false` if the input ends. If the
+// input is known to hold them all, they are read with a single allocation, otherwise in chunks, growing the
+// buffer geometrically
+template <typename Vector, typename Read>
+bool read_elements(Vector& v, size_t count, bool known_to_fit, Read read) {
+  using T = typename Vector::value_type;
+  size_t step = known_to_fit ? count : std::max<size_t>(1, read_chunk_bytes / sizeof(T));
+  while (v.size() != count) {
+    size_t old_size = v.size();
+    size_t new_size = old_size + std::min(step, count - old_size);
+    if (new_size > v.capacity()) {
+      v.reserve(std::max(new_size, std::min(count, 2 * v.capacity())));
+    }
+    v.resize_for_overwrite(new_size);
+    if (!read(v.data() + old_size, (new_size - old_size) * sizeof(T))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Bytes left until the end of `in`, or -1 if the stream can't seek. Keeps the position and the state of `in`
+inline std::streamoff remaining_bytes(std::istream& in) {
+  std::ios_base::iostate state = in.rdstate();
+  std::streampos current = in.tellg();
+  if (current == std::streampos(-1)) {
+    return -1;
+  }
+  std::streampos end = in.seekg(0, std::ios_base::end) ? in.tellg() : std::streampos(-1);
+  in.clear(state);
+  in.seekg(current);
+  if (end == std::streampos(-1) || !in) {
+    in.clear(state);
+    return -1;
+  }
+  return end - current;
+}
+
+template <typename T>
+inline constexpr bool is_serializable = std::is_trivially_copyable_v<T> && std::default_initializable<T>;
+
+} // namespace detail
+
+// O(N)
+template <typename T, typename Allocator, size_t InlineCapacity, typename GrowthPolicy>
+  requires detail::is_serializable<T>
+std::ostream& write_to(std::ostream& out, const vector<T, Allocator, InlineCapacity, GrowthPolicy>& v) {
+  detail::vector_io_header header;
+  header.element_size = sizeof(T);
+  header.size = v.size();
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(T)));
+  return out;
+}
+
+// O(N) basic, the elements are read straight into the buffer, with a single allocation if `in` can seek and
+// in chunks otherwise, so a corrupt size never allocates beyond the input. Sets `failbit` of `in` and leaves
+// `v` empty if the input is truncated or doesn't contain a vector of `T`
+template <typename T, typename Allocator, size_t InlineCapacity, typename GrowthPolicy>
+  requires detail::is_serializable<T>
+std::istream& read_from(std::istream& in, vector<T, Allocator, InlineCapacity, GrowthPolicy>& v) {
+  v.clear();
+  detail::vector_io_header header;
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    return in;
+  }
+  bool swapped;
+  if (!detail::check_header<T>(header, swapped)) {
+    in.setstate(std::ios_base::failbit);
+    return in;
+  }
+
+  std::streamoff remaining = detail::remaining_bytes(in);
+  if (remaining >= 0 && header.size > static_cast<uint64_t>(remaining) / sizeof(T)) {
+    in.setstate(std::ios_base::failbit);
+    return in;
+  }
+  auto read = [&in](void* dst, size_t bytes) {
+    return static_cast<bool>(in.read(static_cast<char*>(dst), static_cast<std::streamsize>(bytes)));
+  };
+  if (!detail::read_elements(v, header.size, remaining >= 0, read)) {
+    v.clear();
+    return in;
+  }
+  if (swapped) {
+    detail::byteswap_each(v.data(), v.size());
+  }
+  return in;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+namespace detail {
+
+[[noreturn]] inline void throw_io_error(const char* what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+// Writes the header and the elements with a single `writev` where possible
+inline void write_all(int fd, const void* header, size_t header_size, const void* data, size_t data_size) {
+  iovec parts[2] = {
+      {const_cast<void*>(header), header_size},
+      {const_cast<void*>(data), data_size},
+  };
+  iovec* current = parts;
+  size_t remaining = 2;
+  while (remaining != 0) {
+    ssize_t written = ::writev(fd, current, static_cast<int>(remaining));
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw_io_error("write_to");
+    }
+    size_t left = written;
+    while (remaining != 0 && left >= current->iov_len) {
+      left -= current->iov_len;
+      ++current;
+      --remaining;
+    }
+    if (remaining != 0) {
+      current->iov_base = static_cast<std::byte*>(current->iov_base) + left;
+      current->iov_len -= left;
+    }
+  }
+}
+
+// Bytes left until the end of the regular file `fd`, or -1 if it isn't one
+inline off_t remaining_bytes(int fd) noexcept {
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    return -1;
+  }
+  off_t current = ::lseek(fd, 0, SEEK_CUR);
+  return current < 0 || current > st.st_size ? -1 : st.st_size - current;
+}
+
+// Returns `false` on end of file before anything was read
+inline bool read_all(int fd, void* data, size_t size) {
+  size_t done = 0;
+  while (done != size) {
+    ssize_t count = ::read(fd, static_cast<std::byte*>(data) + done, size - done);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw_io_error("read_from");
+    }
+    if (count == 0) {
+      if (done == 0) {
+        return false;
+      }
+      throw std::system_error(std::make_error_code(std::errc::io_error), "read_from: unexpected end of file");
+    }
+    done += count;
+  }
+  return true;
+}
+
+} // namespace detail
+
+// O(N), throws `std::system_error` if writing fails
+template <typename T, typename Allocator, size_t InlineCapacity, typename GrowthPolicy>
+  requires detail::is_serializable<T>
+void write_to(int fd, const vector<T, Allocator, InlineCapacity, GrowthPolicy>& v) {
+  detail::vector_io_header header;
+  header.element_size = sizeof(T);
+  header.size = v.size();
+  detail::write_all(fd, &header, sizeof(header), v.data(), v.size() * sizeof(T));
+}
+
+// O(N) basic, returns `false` at the end of the input. Throws `std::system_error` if reading fails or the
+// input doesn't contain a vector of `T`, leaving `v` empty. Like the stream version, allocates at once only for
+// regular files that are long enough, and reads other inputs in chunks
+template <typename T, typename Allocator, size_t InlineCapacity, typename GrowthPolicy>
+  requires detail::is_serializable<T>
+bool read_from(int fd, vector<T, Allocator, InlineCapacity, GrowthPolicy>& v) {
+  v.clear();
+  detail::vector_io_header header;
+  if (!detail::read_all(fd, &header, sizeof(header))) {
+    return false;
+  }
+  bool swapped;
+  if (!detail::check_header<T>(header, swapped)) {
+    throw std::system_error(std::make_error_code(std::errc::illegal_byte_sequence), "read_from");
+  }
+  off_t remaining = detail::remaining_bytes(fd);
+  if (remaining >= 0 && header.size > static_cast<uint64_t>(remaining) / sizeof(T)) {
+    throw std::system_error(std::make_error_code(std::errc::io_error), "read_from: unexpected end of file");
+  }
+  auto read = [fd](void* dst, size_t bytes) { return detail::read_all(fd, dst, bytes); };
+  try {
+    if (!detail::read_elements(v, header.size, remaining >= 0, read)) {
+      throw std::system_error(std::make_error_code(std::errc::io_error), "read_from: unexpected end of file");
+    }
+  } catch (...) {
+    v.clear();
+    throw;
+  }
+  if (swapped) {
+    detail::byteswap_each(v.data(), v.size());
+  }
+  return true;
+}
+
+#endif
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+// Counters collected for every `vector` instantiation when `VECTOR_STATS` is defined (the `USE_VECTOR_STATS`
+// CMake option). Without it they stay zero and counting compiles to nothing. Nothing is counted during constant
+// evaluation.
+struct vector_stats {
+  size_t allocations = 0;
+  size_t allocated_bytes = 0;
+  // Moves of the elements to a new buffer, including `reserve` and `shrink_to_fit`
+  size_t reallocations = 0;
+  // Elements constructed by copying or moving another element, bytewise relocations count as moves
+  size_t copies = 0;
+  size_t moves = 0;
+
+  friend bool operator==(const vector_stats&, const vector_stats&) = default;
+};
+
+// Heap memory held by a vector, in bytes. `reserved` is the size of the buffer, `used` is the part occupied by the
+// elements, and the slack between them is what `shrink_to_fit` would give back. Inline buffers live inside the
+// vector object and are not counted
+struct vector_memory_usage {
+  size_t used = 0;
+  size_t reserved = 0;
+
+  constexpr size_t slack() const noexcept {
+    return reserved - used;
+  }
+
+  constexpr vector_memory_usage& operator+=(const vector_memory_usage& other) noexcept {
+    used += other.used;
+    reserved += other.reserved;
+    return *this;
+  }
+
+  friend bool operator==(const vector_memory_usage&, const vector_memory_usage&) = default;
+};
+
+namespace detail {
+
+#ifdef VECTOR_STATS
+inline constexpr bool stats_enabled = true;
+#else
+inline constexpr bool stats_enabled = false;
+#endif
+
+class atomic_vector_stats {
+public:
+  constexpr void add_allocation(size_t bytes) noexcept {
+    if (std::is_constant_evaluated()) {
+      return;
+    }
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  constexpr void add_reallocation() noexcept {
+    if (std::is_constant_evaluated()) {
+      return;
+    }
+    reallocations.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  constexpr void add_copies(size_t count) noexcept {
+    if (std::is_constant_evaluated()) {
+      return;
+    }
+    copies.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  constexpr void add_moves(size_t count) noexcept {
+    if (std::is_constant_evaluated()) {
+      return;
+    }
+    moves.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  vector_stats snapshot() const noexcept {
+    return {
+        allocations.load(std::memory_order_relaxed),
+        allocated_bytes.load(std::memory_order_relaxed),
+        reallocations.load(std::memory_order_relaxed),
+        copies.load(std::memory_order_relaxed),
+        moves.load(std::memory_order_relaxed),
+    };
+  }
+
+  void reset() noexcept {
+    allocations.store(0, std::memory_order_relaxed);
+    allocated_bytes.store(0, std::memory_order_relaxed);
+    reallocations.store(0, std::memory_order_relaxed);
+    copies.store(0, std::memory_order_relaxed);
+    moves.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<size_t> allocations = 0;
+  std::atomic<size_t> allocated_bytes = 0;
+  std::atomic<size_t> reallocations = 0;
+  std::atomic<size_t> copies = 0;
+  std::atomic<size_t> moves = 0;
+};
+
+struct no_vector_stats {
+  constexpr void add_allocation(size_t) noexcept {}
+
+  constexpr void add_reallocation() noexcept {}
+
+  constexpr void add_copies(size_t) noexcept {}
+
+  constexpr void add_moves(size_t) noexcept {}
+
+  vector_stats snapshot() const noexcept {
+    return {};
+  }
+
+  void reset() noexcept {}
+};
+
+using vector_stats_storage = std::conditional_t<stats_enabled, atomic_vector_stats, no_vector_stats>;
+
+} // namespace detail
@@ -1,11 +1,95 @@
 #pragma once
 
+#include "growth-policy.h"
+#include "parallel.h"
+#include "simd.h"
+#include "vector-checks.h"
+#include "vector-stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <compare>
+#include <concepts>
 #include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+// Marks slow paths, such as reallocation, so that they are kept out of line and away from the hot code, and
+// the call sites of the fast paths stay small enough to be inlined
+#if defined(__GNUC__)
+#define VECTOR_SLOW_PATH [[gnu::noinline, gnu::cold]]
+#elif defined(_MSC_VER)
+#define VECTOR_SLOW_PATH __declspec(noinline)
+#else
+#define VECTOR_SLOW_PATH
+#endif
+
+// Types for which moving an object to a new address and forgetting the old one is equivalent to `memcpy`.
+// Specialize for types that own their resources through pointers, but are not trivially copyable.
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+namespace detail {
+
+template <typename T, size_t N>
+struct inline_storage {
+  alignas(T) std::byte bytes[N * sizeof(T)];
+};
+
+template <typename T>
+struct inline_storage<T, 0> {};
+
+// Whether `std::allocator_traits` construct elements with `Allocator::construct` rather than placement new
+template <typename Allocator, typename T, typename... Args>
+concept has_custom_construct = requires(Allocator& alloc, T* ptr, Args&&... args) {
+  alloc.construct(ptr, std::forward<Args>(args)...);
+};
+
+template <typename Allocator, typename T>
+concept has_custom_destroy = requires(Allocator& alloc, T* ptr) { alloc.destroy(ptr); };
+
+template <typename T>
+concept reports_memory_usage = requires(const T& x) {
+  { x.deep_memory_usage() } -> std::same_as<vector_memory_usage>;
+};
 
 template <typename T>
+struct is_nothrow_relocatable
+    : std::bool_constant<
+          is_trivially_relocatable_v<T> ||
+          std::is_nothrow_constructible_v<T, decltype(std::move_if_noexcept(std::declval<T&>()))>> {};
+
+} // namespace detail
+
+// Up to `InlineCapacity` elements are stored inside the vector object itself, without allocations.
+// See `small_vector` below
+template <typename T, typename Allocator = std::allocator<T>, size_t InlineCapacity = 0,
+          typename GrowthPolicy = default_growth>
 class vector {
+  using alloc_traits = std::allocator_traits<Allocator>;
+
+  // Taking over the storage of another vector only moves elements if they are stored inline.
+  // `T` may be incomplete here, so the trait is not instantiated unless there is inline storage
+  static constexpr bool nothrow_steal =
+      std::disjunction_v<std::bool_constant<InlineCapacity == 0>, detail::is_nothrow_relocatable<T>>;
+
+  // Insertions shift the tail with `memmove` before constructing new elements instead of rotating it afterwards
+  static constexpr bool shift_in_place = std::is_trivially_copyable_v<T>;
+
+  static_assert(std::is_same_v<typename alloc_traits::value_type, T>, "Allocator::value_type must be T");
+  static_assert(std::is_same_v<typename alloc_traits::pointer, T*>, "Fancy pointers are not supported");
+
 public:
   using value_type = T;
+  using allocator_type = Allocator;
 
   using reference = T&;
   using const_reference = const T&;
@@ -13,97 +97,1211 @@ public:
   using pointer = T*;
   using const_pointer = const T*;
 
-  using iterator = pointer;
-  using const_iterator = const_pointer;
+  // Plain pointers unless `VECTOR_CHECKED` is defined, see vector-checks.h
+  using iterator = std::conditional_t<detail::checks_enabled, detail::checked_iterator<T, vector>, pointer>;
+  using const_iterator =
+      std::conditional_t<detail::checks_enabled, detail::checked_iterator<const T, vector>, const_pointer>;
+
+  // Buffer of `capacity` elements allocated with the allocator of the vector, of which the first `size` are
+  // constructed
+  struct raw_buffer {
+    T* data;
+    size_t size;
+    size_t capacity;
+  };
 
 public:
   // O(1) nothrow
-  vector() noexcept;
+  vector() noexcept(std::is_nothrow_default_constructible_v<Allocator>) = default;
+
+  // O(1) nothrow
+  explicit constexpr vector(const Allocator& alloc) noexcept
+      : alloc_(alloc) {}
+
+  // O(N) strong
+  constexpr vector(const vector& other)
+      : vector(other, alloc_traits::select_on_container_copy_construction(other.alloc_)) {}
 
   // O(N) strong
-  vector(const vector& other);
+  constexpr vector(const vector& other, const Allocator& alloc)
+      : alloc_(alloc) {
+    T* new_data = allocate(other.size_);
+    try {
+      copy_construct(other.data_, other.size_, new_data);
+    } catch (...) {
+      deallocate(new_data, other.size_);
+      throw;
+    }
+    data_ = new_data;
+    size_ = other.size_;
+    capacity_ = std::max(other.size_, InlineCapacity);
+  }
+
+  // O(N / threads) strong
+  vector(const parallel_policy& policy, const vector& other)
+      : vector(policy, other, alloc_traits::select_on_container_copy_construction(other.alloc_)) {}
 
-  // O(1) strong
-  vector(vector&& other);
+  // O(N / threads) strong
+  vector(const parallel_policy& policy, const vector& other, const Allocator& alloc)
+      : alloc_(alloc) {
+    parallel_construct(policy, other.size_, [&](T* dst, size_t begin, size_t end) {
+      copy_construct(other.data_ + begin, end - begin, dst);
+    });
+  }
+
+  // O(1) strong, O(N) strong if elements are stored inline
+  constexpr vector(vector&& other) noexcept(nothrow_steal)
+      : alloc_(std::move(other.alloc_)) {
+    steal_storage(other);
+  }
+
+  // O(1) strong if allocators are equal, O(N) strong otherwise
+  constexpr vector(vector&& other, const Allocator& alloc)
+      : alloc_(alloc) {
+    if (alloc_ == other.alloc_) {
+      steal_storage(other);
+      return;
+    }
+    T* new_data = allocate(other.size_);
+    try {
+      move_construct(other.data_, other.size_, new_data);
+    } catch (...) {
+      deallocate(new_data, other.size_);
+      throw;
+    }
+    data_ = new_data;
+    size_ = other.size_;
+    capacity_ = std::max(other.size_, InlineCapacity);
+  }
 
   // O(N) strong
-  vector& operator=(const vector& other);
+  constexpr vector& operator=(const vector& other) {
+    if (this != &other) {
+      replace_with_copy(vector(other, copy_assignment_allocator(other)));
+    }
+    return *this;
+  }
 
-  // O(1) strong
-  vector& operator=(vector&& other);
+  // O(N / threads) strong
+  void parallel_assign(const parallel_policy& policy, const vector& other) {
+    if (this != &other) {
+      replace_with_copy(vector(policy, other, copy_assignment_allocator(other)));
+    }
+  }
+
+  // O(1) strong if allocators propagate or are equal, O(N) strong otherwise or if elements are stored inline
+  constexpr vector& operator=(vector&& other) noexcept(
+      (alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) &&
+      nothrow_steal
+  ) {
+    if (this == &other) {
+      return *this;
+    }
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+      other.prepare_steal();
+      release_storage();
+      alloc_ = std::move(other.alloc_);
+      steal_storage(other);
+    } else if (alloc_ == other.alloc_) {
+      other.prepare_steal();
+      release_storage();
+      steal_storage(other);
+    } else {
+      vector tmp(std::move(other), alloc_);
+      tmp.prepare_steal();
+      release_storage();
+      steal_storage(tmp);
+    }
+    return *this;
+  }
 
   // O(N) nothrow
-  ~vector() noexcept;
+  constexpr ~vector() noexcept {
+    release_storage();
+  }
+
+  // O(1) nothrow, takes ownership of `buffer`, which must have been allocated by an allocator equal to `alloc`
+  static constexpr vector from_raw(raw_buffer buffer, const Allocator& alloc = Allocator()) noexcept {
+    vector result(alloc);
+    if (buffer.data != nullptr) {
+      result.data_ = buffer.data;
+      result.size_ = buffer.size;
+      result.capacity_ = buffer.capacity;
+    }
+    return result;
+  }
+
+  // O(1) nothrow, O(N) strong if elements are stored inline. Gives up the buffer without destroying the
+  // elements, leaving the vector empty. The caller must destroy them and deallocate it with `get_allocator()`
+  constexpr raw_buffer release() {
+    move_to_heap();
+    if (is_inline()) {
+      size_ = 0;
+      return {nullptr, 0, 0};
+    }
+    raw_buffer result{data_, size_, capacity_};
+    generation_.advance();
+    data_ = inline_data();
+    size_ = 0;
+    capacity_ = InlineCapacity;
+    return result;
+  }
+
+  // O(N + M) basic, `value` must not refer to an element of this vector
+  constexpr void assign(size_t count, const T& value) {
+    if (count > capacity_) {
+      T* new_data = allocate(count);
+      try {
+        fill_construct(new_data, count, value);
+      } catch (...) {
+        deallocate(new_data, count);
+        throw;
+      }
+      release_storage();
+      data_ = new_data;
+      size_ = count;
+      capacity_ = count;
+      return;
+    }
+    clear();
+    fill_construct(data_, count, value);
+    size_ = count;
+  }
+
+  // O(N / threads + M) strong
+  void parallel_fill(const parallel_policy& policy, size_t count, const T& value) {
+    vector tmp(alloc_);
+    tmp.parallel_construct(policy, count, [&](T* dst, size_t begin, size_t end) {
+      tmp.fill_construct(dst, end - begin, value);
+    });
+    replace_with(tmp);
+  }
+
+  // O(N / threads + M) strong, replaces the elements with `f(x)` for each `x` in `[first, last)`.
+  // `f` is called concurrently
+  template <std::random_access_iterator It, typename F>
+  void parallel_transform(const parallel_policy& policy, It first, It last, F f) {
+    vector tmp(alloc_);
+    tmp.parallel_construct(policy, last - first, [&](T* dst, size_t begin, size_t end) {
+      tmp.generate_construct(dst, end - begin, [&](size_t i) -> decltype(auto) { return f(first[begin + i]); });
+    });
+    replace_with(tmp);
+  }
+
+  // O(N + M) basic
+  template <std::input_iterator InputIt>
+  constexpr void assign(InputIt first, InputIt last) {
+    assign_iterators(std::move(first), std::move(last));
+  }
+
+  // O(N + M) basic
+  constexpr void assign(std::initializer_list<T> values) {
+    assign_iterators(values.begin(), values.end());
+  }
+
+  // O(N + M) basic
+  template <std::ranges::input_range Range>
+  constexpr void assign_range(Range&& range) {
+    assign_iterators(std::ranges::begin(range), std::ranges::end(range));
+  }
 
   // O(1) nothrow
-  reference operator[](size_t index);
+  constexpr allocator_type get_allocator() const noexcept {
+    return alloc_;
+  }
+
+  // O(1) nothrow, counters shared by all vectors of this type, see `vector_stats`
+  static vector_stats stats() noexcept {
+    return stats_.snapshot();
+  }
 
   // O(1) nothrow
-  const_reference operator[](size_t index) const;
+  static void reset_stats() noexcept {
+    stats_.reset();
+  }
+
+  // O(1) nothrow, the buffer of this vector only, see `vector_memory_usage`
+  constexpr vector_memory_usage memory_usage() const noexcept {
+    if (is_inline()) {
+      return {};
+    }
+    return {size_ * sizeof(T), capacity_ * sizeof(T)};
+  }
+
+  // O(N) nothrow, also adds the usage of elements that report it themselves, such as nested vectors
+  constexpr vector_memory_usage deep_memory_usage() const noexcept {
+    vector_memory_usage result = memory_usage();
+    if constexpr (detail::reports_memory_usage<T>) {
+      for (size_t i = 0; i != size_; ++i) {
+        result += data_[i].deep_memory_usage();
+      }
+    }
+    return result;
+  }
+
+  // O(1) nothrow
+  constexpr reference operator[](size_t index) {
+    detail::check(index < size_, "index out of range");
+    return data_[index];
+  }
+
+  // O(1) nothrow
+  constexpr const_reference operator[](size_t index) const {
+    detail::check(index < size_, "index out of range");
+    return data_[index];
+  }
 
   // O(1) nothrow
-  pointer data() noexcept;
+  constexpr pointer data() noexcept {
+    return data_;
+  }
 
   // O(1) nothrow
-  const_pointer data() const noexcept;
+  constexpr const_pointer data() const noexcept {
+    return data_;
+  }
 
   // O(1) nothrow
-  size_t size() const noexcept;
+  constexpr size_t size() const noexcept {
+    return size_;
+  }
 
   // O(1) nothrow
-  reference front();
+  constexpr reference front() {
+    detail::check(size_ != 0, "front() of an empty vector");
+    return data_[0];
+  }
 
   // O(1) nothrow
-  const_reference front() const;
+  constexpr const_reference front() const {
+    detail::check(size_ != 0, "front() of an empty vector");
+    return data_[0];
+  }
 
   // O(1) nothrow
-  reference back();
+  constexpr reference back() {
+    detail::check(size_ != 0, "back() of an empty vector");
+    return data_[size_ - 1];
+  }
 
   // O(1) nothrow
-  const_reference back() const;
+  constexpr const_reference back() const {
+    detail::check(size_ != 0, "back() of an empty vector");
+    return data_[size_ - 1];
+  }
+
+  // O(1)* strong
+  constexpr void push_back(const T& value) {
+    emplace_back(value);
+  }
 
   // O(1)* strong
-  void push_back(const T& value);
+  constexpr void push_back(T&& value) {
+    emplace_back(std::move(value));
+  }
+
+  // O(1)* strong
+  template <typename... Args>
+  constexpr reference emplace_back(Args&&... args) {
+    if (size_ == capacity_) [[unlikely]] {
+      return emplace_back_reallocate(std::forward<Args>(args)...);
+    }
+    return unchecked_emplace_back(std::forward<Args>(args)...);
+  }
+
+  // O(1) strong, the vector must not be full, e.g. after `reserve`
+  constexpr void unchecked_push_back(const T& value) {
+    unchecked_emplace_back(value);
+  }
+
+  // O(1) strong, the vector must not be full, e.g. after `reserve`
+  constexpr void unchecked_push_back(T&& value) {
+    unchecked_emplace_back(std::move(value));
+  }
+
+  // O(1) strong, the vector must not be full, e.g. after `reserve`
+  template <typename... Args>
+  constexpr reference unchecked_emplace_back(Args&&... args) {
+    detail::check(size_ != capacity_, "unchecked_emplace_back() of a full vector");
+    construct_element(data_ + size_, std::forward<Args>(args)...);
+    return data_[size_++];
+  }
 
   // O(1) nothrow
-  void pop_back();
+  constexpr void pop_back() {
+    detail::check(size_ != 0, "pop_back() of an empty vector");
+    --size_;
+    alloc_traits::destroy(alloc_, data_ + size_);
+  }
 
   // O(1) nothrow
-  bool empty() const noexcept;
+  constexpr bool empty() const noexcept {
+    return size_ == 0;
+  }
 
   // O(1) nothrow
-  size_t capacity() const noexcept;
+  constexpr size_t capacity() const noexcept {
+    return capacity_;
+  }
 
   // O(N) strong
-  void reserve(size_t new_capacity);
+  constexpr void reserve(size_t new_capacity) {
+    if (new_capacity > capacity_) {
+      reallocate(new_capacity);
+    }
+  }
 
   // O(N) strong
-  void shrink_to_fit();
+  constexpr void shrink_to_fit() {
+    if (size_ != capacity_ && !is_inline()) {
+      reallocate(size_);
+    }
+  }
 
-  // O(N) nothrow
-  void clear() noexcept;
+  // O(N) strong, reduces the capacity to `new_capacity`, but not below the size
+  constexpr void shrink_to(size_t new_capacity) {
+    new_capacity = std::max(new_capacity, size_);
+    if (new_capacity < capacity_ && !is_inline()) {
+      reallocate(new_capacity);
+    }
+  }
 
-  // O(1) nothrow
-  void swap(vector& other) noexcept;
+  // O(N) strong
+  constexpr void resize(size_t count)
+    requires std::default_initializable<T>
+  {
+    resize_with(count, [&](T* dst, size_t extra) { value_construct(dst, extra); });
+  }
+
+  // O(N) strong
+  constexpr void resize(size_t count, const T& value) {
+    resize_with(count, [&](T* dst, size_t extra) { fill_construct(dst, extra, value); });
+  }
+
+  // O(N) strong, new elements are default-initialized, so trivially default-constructible ones are left
+  // uninitialized and must be written before being read
+  constexpr void resize_for_overwrite(size_t count)
+    requires std::default_initializable<T>
+  {
+    resize_with(count, [&](T* dst, size_t extra) { default_construct(dst, extra); });
+  }
+
+  // O(N) nothrow, O(1) for trivially destructible elements. Keeps the capacity, so refilling the vector up to
+  // the previous size doesn't allocate
+  constexpr void clear() noexcept {
+    destroy(data_, size_);
+    size_ = 0;
+  }
+
+  // O(1) nothrow, O(N) nothrow(move) if elements are stored inline, O(N) strong if relocating them may throw.
+  // Inline elements that may throw on relocation are moved to the heap first
+  constexpr void swap(vector& other) noexcept(nothrow_steal) {
+    if (is_inline() || other.is_inline()) {
+      // Nothing below can throw once both are prepared
+      prepare_steal();
+      other.prepare_steal();
+      vector tmp(std::move(other), other.get_allocator());
+      other.steal_storage(*this);
+      steal_storage(tmp);
+    } else {
+      std::swap(data_, other.data_);
+      std::swap(size_, other.size_);
+      std::swap(capacity_, other.capacity_);
+      generation_.advance();
+      other.generation_.advance();
+    }
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+      using std::swap;
+      swap(alloc_, other.alloc_);
+    }
+  }
+
+  // O(1) nothrow, O(N) nothrow(move) if elements are stored inline, O(N) strong if relocating them may throw
+  friend constexpr void swap(vector& lhs, vector& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+  }
 
   // O(1) nothrow
-  iterator begin() noexcept;
+  constexpr iterator begin() noexcept {
+    return make_iterator(0);
+  }
 
   // O(1) nothrow
-  iterator end() noexcept;
+  constexpr iterator end() noexcept {
+    return make_iterator(size_);
+  }
 
   // O(1) nothrow
-  const_iterator begin() const noexcept;
+  constexpr const_iterator begin() const noexcept {
+    return make_iterator(0);
+  }
 
   // O(1) nothrow
-  const_iterator end() const noexcept;
+  constexpr const_iterator end() const noexcept {
+    return make_iterator(size_);
+  }
+
+  // O(N) strong
+  constexpr iterator insert(const_iterator pos, const T& value) {
+    return emplace(pos, value);
+  }
 
   // O(N) strong
-  iterator insert(const_iterator pos, const T& value);
+  constexpr iterator insert(const_iterator pos, T&& value) {
+    return emplace(pos, std::move(value));
+  }
+
+  // O(N + M) strong
+  constexpr iterator insert(const_iterator pos, size_t count, const T& value) {
+    if constexpr (shift_in_place) {
+      // `value` may be an element that is about to be shifted
+      T copy = value;
+      return insert_with(index_of(pos), count, [&](T* dst) { fill_construct(dst, count, copy); });
+    } else {
+      return insert_with(index_of(pos), count, [&](T* dst) { fill_construct(dst, count, value); });
+    }
+  }
+
+  // O(N + M) strong
+  template <std::input_iterator InputIt>
+  constexpr iterator insert(const_iterator pos, InputIt first, InputIt last) {
+    return insert_iterators(index_of(pos), std::move(first), std::move(last));
+  }
+
+  // O(N + M) strong
+  constexpr iterator insert(const_iterator pos, std::initializer_list<T> values) {
+    return insert_iterators(index_of(pos), values.begin(), values.end());
+  }
+
+  // O(N + M) strong
+  template <std::ranges::input_range Range>
+  constexpr iterator insert_range(const_iterator pos, Range&& range) {
+    return insert_iterators(index_of(pos), std::ranges::begin(range), std::ranges::end(range));
+  }
+
+  // O(M)* strong
+  template <std::ranges::input_range Range>
+  constexpr void append_range(Range&& range) {
+    insert_iterators(size_, std::ranges::begin(range), std::ranges::end(range));
+  }
+
+  // O(N) strong
+  template <typename... Args>
+  constexpr iterator emplace(const_iterator pos, Args&&... args) {
+    if constexpr (shift_in_place) {
+      if (size_ != capacity_) {
+        // `args` may refer to an element that is about to be shifted
+        T value(std::forward<Args>(args)...);
+        return insert_with(index_of(pos), 1, [&](T* dst) { construct_element(dst, std::move(value)); });
+      }
+    }
+    return insert_with(index_of(pos), 1, [&](T* dst) {
+      construct_element(dst, std::forward<Args>(args)...);
+    });
+  }
 
   // O(N) nothrow(swap)
-  iterator erase(const_iterator pos);
+  constexpr iterator erase(const_iterator pos) {
+    return erase(pos, pos + 1);
+  }
 
   // O(N) nothrow(swap)
-  iterator erase(const_iterator first, const_iterator last);
+  constexpr iterator erase(const_iterator first, const_iterator last) {
+    size_t index = index_of(first);
+    size_t last_index = index_of(last);
+    detail::check(index <= last_index && last_index <= size_, "erasing an invalid range");
+    size_t count = last_index - index;
+    using std::swap;
+    for (size_t i = index; i + count < size_; ++i) {
+      swap(data_[i], data_[i + count]);
+    }
+    destroy(data_ + size_ - count, count);
+    size_ -= count;
+    return make_iterator(index);
+  }
+
+  // O(1) nothrow(swap), the last element takes the place of the erased one, so the order is not preserved
+  constexpr iterator swap_remove(const_iterator pos) {
+    size_t index = index_of(pos);
+    detail::check(index < size_, "erasing the end iterator");
+    if (index != size_ - 1) {
+      if constexpr (shift_in_place) {
+        data_[index] = data_[size_ - 1];
+      } else {
+        using std::swap;
+        swap(data_[index], data_[size_ - 1]);
+      }
+    }
+    pop_back();
+    return make_iterator(index);
+  }
+
+  // O(N) nothrow(swap), basic if `pred` throws. Removes all the elements satisfying `pred` in a single pass,
+  // keeping the order of the others, and returns the number of removed elements
+  template <typename Predicate>
+  friend constexpr size_t erase_if(vector& v, Predicate pred) {
+    size_t kept = 0;
+    using std::swap;
+    for (size_t i = 0; i != v.size_; ++i) {
+      if (!pred(std::as_const(v.data_[i]))) {
+        if (kept != i) {
+          if constexpr (shift_in_place) {
+            v.data_[kept] = v.data_[i];
+          } else {
+            swap(v.data_[kept], v.data_[i]);
+          }
+        }
+        ++kept;
+      }
+    }
+    size_t removed = v.size_ - kept;
+    v.destroy(v.data_ + kept, removed);
+    v.size_ = kept;
+    return removed;
+  }
+
+  // O(N) nothrow(swap), basic if comparison throws
+  template <typename U>
+  friend constexpr size_t erase(vector& v, const U& value) {
+    return erase_if(v, [&](const T& element) { return element == value; });
+  }
+
+  // O(N / threads), returns the first element equal to `value`, or `end()`
+  template <typename U>
+  friend iterator parallel_find(const parallel_policy& policy, vector& v, const U& value) {
+    return v.make_iterator(v.find_index(policy, value));
+  }
+
+  // O(N / threads)
+  template <typename U>
+  friend const_iterator parallel_find(const parallel_policy& policy, const vector& v, const U& value) {
+    return v.make_iterator(v.find_index(policy, value));
+  }
+
+  // O(N) nothrow, vectorized for arithmetic elements. Returns the first element equal to `value`, or `end()`
+  friend constexpr iterator find(vector& v, const T& value)
+    requires std::equality_comparable<T>
+  {
+    return v.make_iterator(v.find_index(value));
+  }
+
+  // O(N) nothrow, vectorized for arithmetic elements
+  friend constexpr const_iterator find(const vector& v, const T& value)
+    requires std::equality_comparable<T>
+  {
+    return v.make_iterator(v.find_index(value));
+  }
+
+  // O(N) nothrow, vectorized for arithmetic elements
+  friend constexpr bool contains(const vector& v, const T& value)
+    requires std::equality_comparable<T>
+  {
+    return v.find_index(value) != v.size_;
+  }
+
+  // O(N) nothrow, vectorized for arithmetic elements. Returns the number of elements equal to `value`
+  friend constexpr size_t count(const vector& v, const T& value)
+    requires std::equality_comparable<T>
+  {
+    if constexpr (detail::simd::is_supported<T>) {
+      if (!std::is_constant_evaluated()) {
+        return detail::simd::count(v.data_, v.size_, value);
+      }
+    }
+    return std::count(v.data_, v.data_ + v.size_, value);
+  }
+
+  // O(N) nothrow, vectorized for integer elements. Returns the first smallest element, or `end()` if empty
+  friend constexpr iterator min_element(vector& v)
+    requires std::totally_ordered<T>
+  {
+    return v.make_iterator(v.extremum_index<false>());
+  }
+
+  // O(N) nothrow, vectorized for integer elements
+  friend constexpr const_iterator min_element(const vector& v)
+    requires std::totally_ordered<T>
+  {
+    return v.make_iterator(v.extremum_index<false>());
+  }
+
+  // O(N) nothrow, vectorized for integer elements. Returns the first largest element, or `end()` if empty
+  friend constexpr iterator max_element(vector& v)
+    requires std::totally_ordered<T>
+  {
+    return v.make_iterator(v.extremum_index<true>());
+  }
+
+  // O(N) nothrow, vectorized for integer elements
+  friend constexpr const_iterator max_element(const vector& v)
+    requires std::totally_ordered<T>
+  {
+    return v.make_iterator(v.extremum_index<true>());
+  }
+
+  // O(N) nothrow, vectorized for arithmetic elements, integers are compared with `memcmp`
+  friend constexpr bool operator==(const vector& lhs, const vector& rhs)
+    requires std::equality_comparable<T>
+  {
+    if (lhs.size_ != rhs.size_) {
+      return false;
+    }
+    if constexpr (detail::simd::is_supported<T>) {
+      if (!std::is_constant_evaluated()) {
+        return detail::simd::equal(lhs.data_, rhs.data_, lhs.size_);
+      }
+    }
+    return std::equal(lhs.data_, lhs.data_ + lhs.size_, rhs.data_);
+  }
+
+  // O(N) nothrow, lexicographic, vectorized for arithmetic elements
+  friend constexpr auto operator<=>(const vector& lhs, const vector& rhs)
+    requires std::three_way_comparable<T>
+  {
+    if constexpr (detail::simd::is_supported<T>) {
+      if (!std::is_constant_evaluated()) {
+        size_t common = std::min(lhs.size_, rhs.size_);
+        size_t index = detail::simd::mismatch(lhs.data_, rhs.data_, common);
+        using result = std::compare_three_way_result_t<T>;
+        return index != common ? result(lhs.data_[index] <=> rhs.data_[index]) : result(lhs.size_ <=> rhs.size_);
+      }
+    }
+    return std::lexicographical_compare_three_way(lhs.data_, lhs.data_ + lhs.size_, rhs.data_,
+                                                  rhs.data_ + rhs.size_);
+  }
+
+private:
+  constexpr iterator make_iterator(size_t index) noexcept {
+    if constexpr (detail::checks_enabled) {
+      return iterator(data_ + index, this, generation_.get());
+    } else {
+      return data_ + index;
+    }
+  }
+
+  constexpr const_iterator make_iterator(size_t index) const noexcept {
+    if constexpr (detail::checks_enabled) {
+      return const_iterator(data_ + index, this, generation_.get());
+    } else {
+      return data_ + index;
+    }
+  }
+
+  // Index of the element at `pos`, which must be a valid iterator into this vector
+  constexpr size_t index_of(const_iterator pos) const noexcept {
+    if constexpr (detail::checks_enabled) {
+      detail::check(pos.owner_ == this, "using an iterator of another vector");
+      pos.check_valid();
+      return pos.ptr_ - data_;
+    } else {
+      return pos - data_;
+    }
+  }
+
+  constexpr T* inline_data() noexcept {
+    if constexpr (InlineCapacity == 0) {
+      return nullptr;
+    } else {
+      return reinterpret_cast<T*>(inline_.bytes);
+    }
+  }
+
+  constexpr bool is_inline() const noexcept {
+    if constexpr (InlineCapacity == 0) {
+      return false;
+    } else {
+      return data_ == reinterpret_cast<const T*>(inline_.bytes);
+    }
+  }
+
+  // Returns the inline buffer if `count` elements fit there. The caller must ensure that it is unused,
+  // and that the capacity is set to `std::max(count, InlineCapacity)`
+  constexpr T* allocate(size_t count) {
+    if (count <= InlineCapacity) {
+      return inline_data();
+    }
+    return allocate_on_heap(count);
+  }
+
+  constexpr T* allocate_on_heap(size_t count) {
+    T* result = alloc_traits::allocate(alloc_, count);
+    stats_.add_allocation(count * sizeof(T));
+    return result;
+  }
+
+  constexpr void deallocate(T* ptr, size_t count) noexcept {
+    if (ptr != inline_data()) {
+      alloc_traits::deallocate(alloc_, ptr, count);
+    }
+  }
+
+  // Destroys elements in reverse order of their construction
+  constexpr void destroy(T* first, size_t count) noexcept {
+    if constexpr (std::is_trivially_destructible_v<T> && !detail::has_custom_destroy<Allocator, T>) {
+      return;
+    }
+    while (count != 0) {
+      --count;
+      alloc_traits::destroy(alloc_, first + count);
+    }
+  }
+
+  // Objects can't be copied bytewise during constant evaluation, so trivially copyable elements are copied one
+  // by one there
+  static constexpr void copy_bytes(T* dst, const T* src, size_t count) noexcept {
+    if (std::is_constant_evaluated()) {
+      for (size_t i = 0; i != count; ++i) {
+        std::construct_at(dst + i, src[i]);
+      }
+    } else if (count != 0) {
+      std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(T));
+    }
+  }
+
+  // The ranges may overlap
+  static constexpr void move_bytes(T* dst, const T* src, size_t count) noexcept {
+    if (std::is_constant_evaluated()) {
+      if (dst < src) {
+        for (size_t i = 0; i != count; ++i) {
+          std::construct_at(dst + i, src[i]);
+        }
+      } else {
+        for (size_t i = count; i != 0; --i) {
+          std::construct_at(dst + i - 1, src[i - 1]);
+        }
+      }
+    } else if (count != 0) {
+      std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(T));
+    }
+  }
+
+  template <typename It>
+  constexpr void copy_construct(It src, size_t count, T* dst) {
+    if constexpr (std::is_trivially_copyable_v<T> && std::contiguous_iterator<It> &&
+                  std::is_same_v<std::iter_value_t<It>, T> &&
+                  !detail::has_custom_construct<Allocator, T, std::iter_reference_t<It>>) {
+      copy_bytes(dst, std::to_address(src), count);
+      stats_.add_copies(count);
+    } else {
+      size_t i = 0;
+      try {
+        for (; i != count; ++i, ++src) {
+          construct_element(dst + i, *src);
+        }
+      } catch (...) {
+        destroy(dst, i);
+        throw;
+      }
+    }
+  }
+
+  constexpr void fill_construct(T* dst, size_t count, const T& value) {
+    size_t i = 0;
+    try {
+      for (; i != count; ++i) {
+        construct_element(dst + i, value);
+      }
+    } catch (...) {
+      destroy(dst, i);
+      throw;
+    }
+  }
+
+  // Constructs `count` elements at `dst` from `generate(i)`
+  template <typename Generate>
+  constexpr void generate_construct(T* dst, size_t count, Generate generate) {
+    size_t i = 0;
+    try {
+      for (; i != count; ++i) {
+        construct_element(dst + i, generate(i));
+      }
+    } catch (...) {
+      destroy(dst, i);
+      throw;
+    }
+  }
+
+  constexpr void value_construct(T* dst, size_t count)
+    requires std::default_initializable<T>
+  {
+    size_t i = 0;
+    try {
+      for (; i != count; ++i) {
+        construct_element(dst + i);
+      }
+    } catch (...) {
+      destroy(dst, i);
+      throw;
+    }
+  }
+
+  // Trivially default-constructible elements are left uninitialized, others are constructed through the
+  // allocator as default-insertion would
+  constexpr void default_construct(T* dst, size_t count)
+    requires std::default_initializable<T>
+  {
+    if constexpr (!std::is_trivially_default_constructible_v<T> || detail::has_custom_construct<Allocator, T>) {
+      value_construct(dst, count);
+    }
+  }
+
+  template <typename... Args>
+  constexpr void construct_element(T* dst, Args&&... args) {
+    alloc_traits::construct(alloc_, dst, std::forward<Args>(args)...);
+    if constexpr (sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, T> && ...)) {
+      if constexpr ((std::is_rvalue_reference_v<Args&&> && ...)) {
+        stats_.add_moves(1);
+      } else {
+        stats_.add_copies(1);
+      }
+    }
+  }
+
+  // Elements are moved if that can't throw (or they can't be copied), and copied otherwise, so `src` is left
+  // intact on exception
+  constexpr void move_construct(T* src, size_t count, T* dst) {
+    size_t i = 0;
+    try {
+      for (; i != count; ++i) {
+        construct_element(dst + i, std::move_if_noexcept(src[i]));
+      }
+    } catch (...) {
+      destroy(dst, i);
+      throw;
+    }
+  }
+
+  // Constructs `count` elements at `dst` from the ones at `src` and destroys the latter. Relocation is bytewise
+  // only at run time: during constant evaluation the lifetimes of the old objects have to end properly
+  constexpr void relocate(T* src, size_t count, T* dst) {
+    if constexpr (is_trivially_relocatable_v<T>) {
+      if (!std::is_constant_evaluated()) {
+        copy_bytes(dst, src, count);
+        stats_.add_moves(count);
+        return;
+      }
+    }
+    move_construct(src, count, dst);
+    destroy(src, count);
+  }
+
+  // Relocates the elements to `dst`, leaving a gap of `gap` elements before `index`
+  constexpr void relocate_with_gap(T* dst, size_t index, size_t gap) {
+    if constexpr (is_trivially_relocatable_v<T>) {
+      if (!std::is_constant_evaluated()) {
+        copy_bytes(dst, data_, index);
+        copy_bytes(dst + index + gap, data_ + index, size_ - index);
+        stats_.add_moves(size_);
+        return;
+      }
+    }
+    move_construct(data_, index, dst);
+    try {
+      move_construct(data_ + index, size_ - index, dst + index + gap);
+    } catch (...) {
+      destroy(dst, index);
+      throw;
+    }
+    destroy(data_, size_);
+  }
+
+  constexpr size_t next_capacity(size_t required) const noexcept {
+    return std::max(required, GrowthPolicy::grow(capacity_, required, sizeof(T)));
+  }
+
+  // Inserts `count` elements before `index` with at most one reallocation and one shift of the tail.
+  // `construct(dst)` must either construct all the elements at `dst`, or throw leaving none
+  template <typename Construct>
+  constexpr iterator insert_with(size_t index, size_t count, Construct construct) {
+    if (count > capacity_ - size_) {
+      size_t new_capacity = next_capacity(size_ + count);
+      T* new_data = allocate(new_capacity);
+      try {
+        construct(new_data + index);
+      } catch (...) {
+        deallocate(new_data, new_capacity);
+        throw;
+      }
+      try {
+        relocate_with_gap(new_data, index, count);
+      } catch (...) {
+        destroy(new_data + index, count);
+        deallocate(new_data, new_capacity);
+        throw;
+      }
+      replace_buffer(new_data, std::max(new_capacity, InlineCapacity));
+      size_ += count;
+    } else if constexpr (shift_in_place) {
+      T* pos = data_ + index;
+      size_t tail = size_ - index;
+      move_bytes(pos + count, pos, tail);
+      stats_.add_moves(tail);
+      try {
+        construct(pos);
+      } catch (...) {
+        move_bytes(pos, pos + count, tail);
+        throw;
+      }
+      size_ += count;
+    } else {
+      construct(data_ + size_);
+      size_ += count;
+      std::rotate(data_ + index, data_ + size_ - count, data_ + size_);
+    }
+    return make_iterator(index);
+  }
+
+  template <typename Construct>
+  constexpr void resize_with(size_t count, Construct construct) {
+    if (count > size_) {
+      size_t extra = count - size_;
+      insert_with(size_, extra, [&](T* dst) { construct(dst, extra); });
+    } else {
+      destroy(data_ + count, size_ - count);
+      size_ = count;
+    }
+  }
+
+  template <typename It, typename Sentinel>
+  constexpr iterator insert_iterators(size_t index, It first, Sentinel last) {
+    if constexpr (std::forward_iterator<It>) {
+      size_t count = std::ranges::distance(first, last);
+      return insert_with(index, count, [&](T* dst) { copy_construct(first, count, dst); });
+    } else {
+      size_t old_size = size_;
+      try {
+        for (; first != last; ++first) {
+          emplace_back(*first);
+        }
+      } catch (...) {
+        destroy(data_ + old_size, size_ - old_size);
+        size_ = old_size;
+        throw;
+      }
+      std::rotate(data_ + index, data_ + old_size, data_ + size_);
+      return make_iterator(index);
+    }
+  }
+
+  template <typename It, typename Sentinel>
+  constexpr void assign_iterators(It first, Sentinel last) {
+    if constexpr (std::forward_iterator<It>) {
+      size_t count = std::ranges::distance(first, last);
+      if (count > capacity_) {
+        T* new_data = allocate(count);
+        try {
+          copy_construct(first, count, new_data);
+        } catch (...) {
+          deallocate(new_data, count);
+          throw;
+        }
+        release_storage();
+        data_ = new_data;
+        size_ = count;
+        capacity_ = count;
+        return;
+      }
+      clear();
+      copy_construct(std::move(first), count, data_);
+      size_ = count;
+    } else {
+      clear();
+      for (; first != last; ++first) {
+        emplace_back(*first);
+      }
+    }
+  }
+
+  // `*this` must be empty, `construct(dst, begin, end)` must construct elements `[begin, end)` at `dst` or throw
+  // leaving none
+  template <typename Construct>
+  void parallel_construct(const parallel_policy& policy, size_t count, Construct construct) {
+    T* new_data = allocate(count);
+    try {
+      detail::parallel_for(
+          policy, count, [&](size_t begin, size_t end) { construct(new_data + begin, begin, end); },
+          [&](size_t begin, size_t end) noexcept { destroy(new_data + begin, end - begin); }
+      );
+    } catch (...) {
+      deallocate(new_data, count);
+      throw;
+    }
+    data_ = new_data;
+    size_ = count;
+    capacity_ = std::max(count, InlineCapacity);
+  }
+
+  template <typename U>
+  size_t find_index(const parallel_policy& policy, const U& value) const {
+    std::atomic<size_t> found = size_;
+    detail::parallel_for(policy, size_, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i != end && i < found.load(std::memory_order_relaxed); ++i) {
+        if (data_[i] == value) {
+          size_t current = found.load(std::memory_order_relaxed);
+          while (i < current && !found.compare_exchange_weak(current, i, std::memory_order_relaxed)) {}
+          return;
+        }
+      }
+    });
+    return found.load(std::memory_order_relaxed);
+  }
+
+  constexpr size_t find_index(const T& value) const
+    requires std::equality_comparable<T>
+  {
+    if constexpr (detail::simd::is_supported<T>) {
+      if (!std::is_constant_evaluated()) {
+        return detail::simd::find(data_, size_, value);
+      }
+    }
+    return std::find(data_, data_ + size_, value) - data_;
+  }
+
+  template <bool Max>
+  constexpr size_t extremum_index() const {
+    if constexpr (detail::simd::is_supported<T>) {
+      if (!std::is_constant_evaluated()) {
+        return detail::simd::extremum<Max>(data_, size_);
+      }
+    }
+    if constexpr (Max) {
+      return std::max_element(data_, data_ + size_) - data_;
+    } else {
+      return std::min_element(data_, data_ + size_) - data_;
+    }
+  }
+
+  constexpr Allocator copy_assignment_allocator(const vector& other) const {
+    return alloc_traits::propagate_on_container_copy_assignment::value ? other.alloc_ : alloc_;
+  }
+
+  // `copy` must use `copy_assignment_allocator()`
+  constexpr void replace_with_copy(vector&& copy) {
+    copy.prepare_steal();
+    release_storage();
+    if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+      alloc_ = copy.alloc_;
+    }
+    steal_storage(copy);
+  }
+
+  // `other` must use an equal allocator
+  constexpr void replace_with(vector& other) {
+    other.prepare_steal();
+    release_storage();
+    steal_storage(other);
+  }
+
+  constexpr void reallocate(size_t new_capacity) {
+    T* new_data = allocate(new_capacity);
+    try {
+      relocate(data_, size_, new_data);
+    } catch (...) {
+      deallocate(new_data, new_capacity);
+      throw;
+    }
+    replace_buffer(new_data, std::max(new_capacity, InlineCapacity));
+  }
+
+  // The new element is constructed before the old ones are relocated, so `args` may refer to an element of `*this`
+  template <typename... Args>
+  VECTOR_SLOW_PATH constexpr reference emplace_back_reallocate(Args&&... args) {
+    size_t new_capacity = next_capacity(size_ + 1);
+    T* new_data = allocate(new_capacity);
+    try {
+      construct_element(new_data + size_, std::forward<Args>(args)...);
+    } catch (...) {
+      deallocate(new_data, new_capacity);
+      throw;
+    }
+    try {
+      relocate(data_, size_, new_data);
+    } catch (...) {
+      alloc_traits::destroy(alloc_, new_data + size_);
+      deallocate(new_data, new_capacity);
+      throw;
+    }
+    replace_buffer(new_data, std::max(new_capacity, InlineCapacity));
+    return data_[size_++];
+  }
+
+  // Old elements must have been already relocated to `new_data`
+  constexpr void replace_buffer(T* new_data, size_t new_capacity) noexcept {
+    if (size_ != 0) {
+      stats_.add_reallocation();
+    }
+    deallocate(data_, capacity_);
+    generation_.advance();
+    data_ = new_data;
+    capacity_ = new_capacity;
+  }
+
+  constexpr void release_storage() noexcept {
+    destroy(data_, size_);
+    deallocate(data_, capacity_);
+    generation_.advance();
+    data_ = inline_data();
+    size_ = 0;
+    capacity_ = InlineCapacity;
+  }
+
+  // `*this` must own no elements, and its allocator must be equal to the one of `other`.
+  // Throws only if elements of `other` are stored inline, and relocating them throws
+  constexpr void steal_storage(vector& other) noexcept(nothrow_steal) {
+    generation_.advance();
+    other.generation_.advance();
+    if (other.is_inline()) {
+      relocate(other.data_, other.size_, data_);
+      size_ = std::exchange(other.size_, 0);
+      return;
+    }
+    data_ = std::exchange(other.data_, other.inline_data());
+    size_ = std::exchange(other.size_, 0);
+    capacity_ = std::exchange(other.capacity_, InlineCapacity);
+  }
+
+  // Makes `steal_storage(*this)` nothrow by moving inline elements that may throw on relocation to the heap
+  constexpr void prepare_steal() {
+    if constexpr (!nothrow_steal) {
+      move_to_heap();
+    }
+  }
+
+  // Relocates inline elements to a heap buffer of exactly their size
+  constexpr void move_to_heap() {
+    if (is_inline() && size_ != 0) {
+      T* new_data = allocate_on_heap(size_);
+      try {
+        relocate(data_, size_, new_data);
+      } catch (...) {
+        alloc_traits::deallocate(alloc_, new_data, size_);
+        throw;
+      }
+      generation_.advance();
+      data_ = new_data;
+      capacity_ = size_;
+    }
+  }
+
+private:
+  static inline detail::vector_stats_storage stats_;
+
+  [[no_unique_address]] Allocator alloc_;
+  [[no_unique_address]] detail::inline_storage<T, InlineCapacity> inline_;
+  T* data_ = inline_data();
+  size_t size_ = 0;
+  size_t capacity_ = InlineCapacity;
+  [[no_unique_address]] detail::generation_storage generation_;
+
+  template <typename, typename>
+  friend class detail::checked_iterator;
 };
+
+// Stores up to `N` elements inline, and allocates only when grows beyond that
+template <typename T, size_t N, typename Allocator = std::allocator<T>, typename GrowthPolicy = default_growth>
+using small_vector = vector<T, Allocator, N, GrowthPolicy>;
+
+template <typename T, typename Allocator, size_t InlineCapacity, typename GrowthPolicy>
+struct is_trivially_relocatable<vector<T, Allocator, InlineCapacity, GrowthPolicy>>
+    : std::bool_constant<
+          InlineCapacity == 0 && (std::is_empty_v<Allocator> || is_trivially_relocatable_v<Allocator>)> {};
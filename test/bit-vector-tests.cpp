@@ -0,0 +1,111 @@
+#include "bit-vector.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace {
+
+std::vector<size_t> set_bits(const bit_vector<>& v) {
+  std::vector<size_t> result;
+  for (size_t i = v.find_first(); i != bit_vector<>::npos; i = v.find_next(i)) {
+    result.push_back(i);
+  }
+  return result;
+}
+
+} // namespace
+
+template class bit_vector<>;
+
+TEST(bit_vector_test, push_back_and_test) {
+  bit_vector<> a;
+  EXPECT_TRUE(a.empty());
+  for (size_t i = 0; i < 200; ++i) {
+    a.push_back(i % 3 == 0);
+  }
+  EXPECT_EQ(200, a.size());
+  EXPECT_GE(a.capacity(), 200);
+  EXPECT_EQ(4, a.words().size());
+  for (size_t i = 0; i < 200; ++i) {
+    ASSERT_EQ(i % 3 == 0, a[i]);
+  }
+  EXPECT_EQ(67, a.count());
+
+  a.flip(1);
+  a.reset(0);
+  a.set(2);
+  std::vector<size_t> bits = set_bits(a);
+  bits.resize(4);
+  EXPECT_EQ((std::vector<size_t>{1, 2, 3, 6}), bits);
+
+  while (a.size() > 64) {
+    a.pop_back();
+  }
+  EXPECT_EQ(1, a.words().size());
+  EXPECT_EQ(23, a.count());
+}
+
+TEST(bit_vector_test, range_set_reset) {
+  bit_vector<> a(300);
+  EXPECT_TRUE(a.none());
+  a.set_range(10, 250);
+  EXPECT_EQ(240, a.count());
+  EXPECT_EQ(10, a.find_first());
+  EXPECT_FALSE(a[9]);
+  EXPECT_TRUE(a[249]);
+  EXPECT_FALSE(a[250]);
+
+  a.reset_range(60, 70);
+  EXPECT_EQ(230, a.count());
+  EXPECT_EQ(70, a.find_next(59));
+  a.reset_range(3, 4);
+  a.set_range(5, 5);
+  EXPECT_EQ(230, a.count());
+
+  a.set_all();
+  EXPECT_TRUE(a.all());
+  EXPECT_EQ(300, a.count());
+  a.flip_all();
+  EXPECT_TRUE(a.none());
+  EXPECT_EQ(bit_vector<>::npos, a.find_first());
+}
+
+TEST(bit_vector_test, resize_keeps_tail_clear) {
+  bit_vector<> a(70, true);
+  EXPECT_EQ(70, a.count());
+  a.resize(65);
+  EXPECT_EQ(65, a.count());
+  a.resize(130);
+  EXPECT_EQ(65, a.count());
+  a.resize(200, true);
+  EXPECT_EQ(135, a.count());
+  EXPECT_EQ(63, a.find_next(62));
+  EXPECT_EQ(64, a.find_next(63));
+  EXPECT_EQ(130, a.find_next(64));
+  a.resize(0);
+  EXPECT_TRUE(a.empty());
+  EXPECT_TRUE(a.words().empty());
+}
+
+TEST(bit_vector_test, bitwise) {
+  bit_vector<> a(150), b(150);
+  a.set_range(0, 100);
+  b.set_range(50, 150);
+
+  EXPECT_EQ(50, (a & b).count());
+  EXPECT_EQ(150, (a | b).count());
+  EXPECT_EQ(100, (a ^ b).count());
+  EXPECT_EQ(50, (a & b).find_first());
+
+  bit_vector<> c = a;
+  EXPECT_EQ(a, c);
+  c ^= a;
+  EXPECT_TRUE(c.none());
+  EXPECT_NE(a, c);
+  c |= b;
+  EXPECT_EQ(b, c);
+  c &= a;
+  EXPECT_EQ(a & b, c);
+}
@@ -0,0 +1,246 @@
+#include "circular-vector.h"
+#include "element.h"
+#include "fault-injection.h"
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <iterator>
+#include <memory_resource>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+
+class circular_vector_test : public ::testing::Test {
+protected:
+  element::no_new_instances_guard instances_guard;
+};
+
+template <typename C>
+std::vector<int> to_ints(const C& c) {
+  fault_injection_disable dg;
+  return std::vector<int>(c.begin(), c.end());
+}
+
+// Builds {first, ..., last - 1} with the head in the middle of the buffer, so that the elements wrap around
+circular_vector<element> make_wrapped(int first, int last) {
+  circular_vector<element> result;
+  result.reserve(last - first);
+  int middle = (first + last) / 2;
+  for (int i = middle; i < last; ++i) {
+    result.push_back(i);
+  }
+  for (int i = middle; i-- > first;) {
+    result.push_front(i);
+  }
+  return result;
+}
+
+} // namespace
+
+template class circular_vector<int>;
+template class circular_vector<element>;
+template class circular_vector<std::string>;
+template class circular_vector<element, std::pmr::polymorphic_allocator<element>>;
+
+static_assert(std::random_access_iterator<circular_vector<int>::iterator>);
+static_assert(std::random_access_iterator<circular_vector<int>::const_iterator>);
+
+TEST_F(circular_vector_test, push_pop_both_ends) {
+  circular_vector<element> a;
+  for (int i = 0; i < 10; ++i) {
+    a.push_back(i);
+    a.push_front(-i - 1);
+  }
+  EXPECT_EQ(20, a.size());
+  EXPECT_EQ(-10, a.front());
+  EXPECT_EQ(9, a.back());
+  std::vector<int> expected;
+  for (int i = -10; i < 10; ++i) {
+    expected.push_back(i);
+  }
+  EXPECT_EQ(expected, to_ints(a));
+
+  a.pop_front();
+  a.pop_back();
+  EXPECT_EQ(-9, a.front());
+  EXPECT_EQ(8, a.back());
+  EXPECT_EQ(18, a.size());
+  EXPECT_EQ(0, a[9]);
+}
+
+TEST_F(circular_vector_test, fifo_does_not_grow) {
+  circular_vector<int> a;
+  a.reserve(8);
+  for (int i = 0; i < 1000; ++i) {
+    a.push_back(i);
+    if (a.size() == 8) {
+      EXPECT_EQ(i - 7, a.front());
+      a.pop_front();
+    }
+  }
+  EXPECT_EQ(8, a.capacity());
+  EXPECT_EQ(7, a.size());
+  EXPECT_EQ(999, a.back());
+
+  for (int i = 1000; i < 1010; ++i) {
+    a.push_back(i);
+  }
+  std::vector<int> expected;
+  for (int i = 993; i < 1010; ++i) {
+    expected.push_back(i);
+  }
+  EXPECT_EQ(expected, to_ints(a));
+}
+
+TEST_F(circular_vector_test, grow_wrapped) {
+  circular_vector<element> a = make_wrapped(0, 16);
+  EXPECT_EQ(16, a.capacity());
+  a.push_back(16);
+  a.push_front(-1);
+  std::vector<int> expected;
+  for (int i = -1; i <= 16; ++i) {
+    expected.push_back(i);
+  }
+  EXPECT_EQ(expected, to_ints(a));
+}
+
+TEST_F(circular_vector_test, linearize) {
+  circular_vector<element> a = make_wrapped(0, 10);
+  std::span<element> elements = a.linearize();
+  ASSERT_EQ(10, elements.size());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(i, elements[i]);
+  }
+  EXPECT_EQ(10, a.capacity());
+  a.pop_front();
+  EXPECT_EQ(elements.data() + 1, &a.front());
+}
+
+TEST_F(circular_vector_test, copy_and_move) {
+  circular_vector<element> a = make_wrapped(0, 20);
+  circular_vector<element> b = a;
+  EXPECT_EQ(to_ints(a), to_ints(b));
+  circular_vector<element> c = std::move(a);
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ(to_ints(b), to_ints(c));
+  a = c;
+  c = std::move(b);
+  EXPECT_EQ(to_ints(a), to_ints(c));
+}
+
+TEST_F(circular_vector_test, pmr_allocator) {
+  using allocator = std::pmr::polymorphic_allocator<element>;
+  std::pmr::unsynchronized_pool_resource pool;
+  std::pmr::memory_resource* heap = std::pmr::new_delete_resource();
+  allocator from_pool(&pool);
+  allocator from_heap(heap);
+  circular_vector<element, allocator> a({1, 2, 3}, from_pool);
+  a.push_front(0);
+  circular_vector<element, allocator> b({4}, from_heap);
+  b = a;
+  EXPECT_EQ(heap, b.get_allocator().resource());
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), to_ints(b));
+
+  circular_vector<element, allocator> c(from_pool);
+  c = std::move(a);
+  EXPECT_EQ(&pool, c.get_allocator().resource());
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), to_ints(c));
+
+  circular_vector<element, allocator> d({5, 6}, from_heap);
+  b = std::move(c);
+  EXPECT_EQ(heap, b.get_allocator().resource());
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), to_ints(b));
+  b.swap(d);
+  EXPECT_EQ((std::vector<int>{5, 6}), to_ints(b));
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), to_ints(d));
+}
+
+TEST_F(circular_vector_test, shrink_to_fit) {
+  circular_vector<element> a = make_wrapped(0, 30);
+  for (int i = 0; i < 25; ++i) {
+    a.pop_front();
+  }
+  a.shrink_to_fit();
+  EXPECT_EQ(5, a.capacity());
+  EXPECT_EQ((std::vector<int>{25, 26, 27, 28, 29}), to_ints(a));
+  a.clear();
+  a.shrink_to_fit();
+  EXPECT_EQ(0, a.capacity());
+}
+
+TEST_F(circular_vector_test, matches_deque) {
+  std::mt19937 gen(42);
+  circular_vector<std::string> a;
+  std::deque<std::string> expected;
+  for (int i = 0; i < 5000; ++i) {
+    switch (gen() % 5) {
+    case 0:
+      a.push_back(std::to_string(i));
+      expected.push_back(std::to_string(i));
+      break;
+    case 1:
+      a.push_front(std::to_string(i));
+      expected.push_front(std::to_string(i));
+      break;
+    case 2:
+      if (!expected.empty()) {
+        a.pop_front();
+        expected.pop_front();
+      }
+      break;
+    case 3:
+      if (!expected.empty()) {
+        a.pop_back();
+        expected.pop_back();
+      }
+      break;
+    default:
+      a.push_back(a.empty() ? "" : a.front());
+      expected.push_back(expected.empty() ? "" : expected.front());
+    }
+    ASSERT_EQ(expected.size(), a.size());
+  }
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), a.begin(), a.end()));
+}
+
+TEST_F(circular_vector_test, push_throw) {
+  faulty_run([] {
+    circular_vector<element> a;
+    {
+      fault_injection_disable dg;
+      a = make_wrapped(0, 8);
+    }
+    try {
+      a.push_front(-1);
+    } catch (...) {
+      fault_injection_disable dg;
+      EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}), to_ints(a));
+      EXPECT_EQ(8, a.capacity());
+      throw;
+    }
+    try {
+      a.push_back(a.front());
+    } catch (...) {
+      fault_injection_disable dg;
+      EXPECT_EQ((std::vector<int>{-1, 0, 1, 2, 3, 4, 5, 6, 7}), to_ints(a));
+      throw;
+    }
+  });
+}
+
+TEST_F(circular_vector_test, copy_throw) {
+  faulty_run([] {
+    circular_vector<element> a;
+    {
+      fault_injection_disable dg;
+      a = make_wrapped(0, 20);
+    }
+    circular_vector<element> b = a;
+    fault_injection_disable dg;
+    EXPECT_EQ(to_ints(a), to_ints(b));
+  });
+}
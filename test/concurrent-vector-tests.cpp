@@ -0,0 +1,126 @@
+#include "concurrent-vector.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+template class concurrent_vector<int>;
+template class concurrent_vector<std::string>;
+
+using layout = detail::segment_layout;
+
+static_assert(layout::segment_of(0) == 0 && layout::segment_of(31) == 0);
+static_assert(layout::segment_of(32) == 1 && layout::segment_of(95) == 1 && layout::segment_of(96) == 2);
+static_assert(layout::segment_of(layout::max_size() - 1) == layout::max_segment_count - 1);
+static_assert(layout::max_size() == std::numeric_limits<size_t>::max() - 31);
+static_assert(concurrent_vector<int>::max_size() == layout::max_size());
+
+TEST(concurrent_vector_test, segment_layout) {
+  for (size_t segment = 0; segment != layout::max_segment_count; ++segment) {
+    size_t first = layout::segment_begin(segment);
+    size_t last = first + layout::segment_size(segment) - 1;
+    for (size_t index : {first, first + 1, last - 1, last}) {
+      ASSERT_EQ(segment, layout::segment_of(index));
+      ASSERT_EQ(index - first, layout::offset_of(index));
+    }
+  }
+  // Indices near the top of `size_t` used to wrap around
+  EXPECT_EQ(layout::max_segment_count, layout::segment_of(std::numeric_limits<size_t>::max()));
+  EXPECT_EQ(layout::max_segment_count - 1, layout::segment_of(std::numeric_limits<size_t>::max() - 32));
+}
+
+TEST(concurrent_vector_test, push_back) {
+  static constexpr size_t N = 10'000;
+
+  concurrent_vector<std::string> a;
+  EXPECT_TRUE(a.empty());
+  std::vector<const std::string*> addresses;
+  for (size_t i = 0; i < N; ++i) {
+    addresses.push_back(&a.push_back(std::to_string(i)));
+  }
+
+  ASSERT_EQ(N, a.size());
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(std::to_string(i), a[i]);
+    ASSERT_EQ(addresses[i], &a[i]);
+    ASSERT_TRUE(a.is_constructed(i));
+  }
+  EXPECT_FALSE(a.is_constructed(N));
+
+  size_t visited = 0;
+  a.for_each([&](const std::string& value) { EXPECT_EQ(std::to_string(visited++), value); });
+  EXPECT_EQ(N, visited);
+
+  a.clear();
+  EXPECT_TRUE(a.empty());
+  a.emplace_back(3, 'x');
+  EXPECT_EQ("xxx", a[0]);
+}
+
+TEST(concurrent_vector_test, concurrent_push_back) {
+  static constexpr size_t THREADS = 8, N = 50'000;
+
+  concurrent_vector<size_t> a;
+  a.reserve(100);
+  std::atomic<bool> done = false;
+  std::thread reader([&] {
+    while (!done.load()) {
+      size_t count = 0;
+      a.for_each([&](size_t) { ++count; });
+      ASSERT_LE(count, a.size());
+    }
+  });
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&a, t] {
+      for (size_t i = 0; i < N; ++i) {
+        size_t& value = a.push_back(t * N + i);
+        ASSERT_EQ(t * N + i, value);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  done = true;
+  reader.join();
+
+  ASSERT_EQ(THREADS * N, a.size());
+  std::vector<size_t> values;
+  a.for_each([&](size_t value) { values.push_back(value); });
+  std::sort(values.begin(), values.end());
+  for (size_t i = 0; i < THREADS * N; ++i) {
+    ASSERT_EQ(i, values[i]);
+  }
+}
+
+TEST(concurrent_vector_test, throwing_constructor) {
+  struct throwing {
+    explicit throwing(bool fail) {
+      if (fail) {
+        throw std::runtime_error("ctor");
+      }
+    }
+  };
+
+  concurrent_vector<throwing> a;
+  a.emplace_back(false);
+  EXPECT_THROW(a.emplace_back(true), std::runtime_error);
+  a.emplace_back(false);
+
+  EXPECT_EQ(3, a.size());
+  EXPECT_TRUE(a.is_constructed(0));
+  EXPECT_FALSE(a.is_constructed(1));
+  EXPECT_TRUE(a.is_constructed(2));
+
+  size_t visited = 0;
+  a.for_each([&](const throwing&) { ++visited; });
+  EXPECT_EQ(2, visited);
+}
@@ -0,0 +1,172 @@
+#include "cow-vector.h"
+#include "element.h"
+#include "fault-injection.h"
+
+#include <gtest/gtest.h>
+
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class cow_vector_test : public ::testing::Test {
+protected:
+  element::no_new_instances_guard instances_guard;
+};
+
+template <typename C>
+std::vector<int> to_ints(const C& c) {
+  fault_injection_disable dg;
+  return std::vector<int>(c.begin(), c.end());
+}
+
+} // namespace
+
+template class cow_vector<int>;
+template class cow_vector<element>;
+template class cow_vector<element, std::pmr::polymorphic_allocator<element>>;
+
+TEST_F(cow_vector_test, default_ctor) {
+  cow_vector<element> a;
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ(nullptr, a.data());
+  EXPECT_FALSE(a.is_shared());
+  EXPECT_TRUE(a.items().empty());
+}
+
+TEST_F(cow_vector_test, copy_shares_elements) {
+  cow_vector<element> a = {1, 2, 3};
+  element::reset_counters();
+
+  cow_vector<element> b = a;
+  cow_vector<element> c;
+  c = b;
+  EXPECT_EQ(0, element::get_copy_counter());
+  EXPECT_EQ(a.data(), b.data());
+  EXPECT_EQ(a.data(), c.data());
+  EXPECT_TRUE(a.is_shared());
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(c));
+}
+
+TEST_F(cow_vector_test, mutation_copies_shared) {
+  cow_vector<element> a = {1, 2, 3};
+  cow_vector<element> b = a;
+
+  element::reset_counters();
+  b.push_back(4);
+  EXPECT_EQ(3, element::get_copy_counter());
+  EXPECT_FALSE(a.is_shared());
+  EXPECT_FALSE(b.is_shared());
+  EXPECT_NE(a.data(), b.data());
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(a));
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 4}), to_ints(b));
+
+  element::reset_counters();
+  b.mutate()[0] = 10;
+  b.pop_back();
+  EXPECT_EQ(0, element::get_copy_counter());
+  EXPECT_EQ((std::vector<int>{10, 2, 3}), to_ints(b));
+}
+
+TEST_F(cow_vector_test, push_back_from_shared) {
+  cow_vector<element> a = {1, 2, 3};
+  cow_vector<element> b = a;
+
+  b.push_back(b[0]);
+  b.emplace_back(b[1]);
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 1, 2}), to_ints(b));
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(a));
+}
+
+TEST_F(cow_vector_test, clear) {
+  cow_vector<element> a = {1, 2, 3};
+  cow_vector<element> b = a;
+
+  b.clear();
+  EXPECT_TRUE(b.empty());
+  EXPECT_EQ(3, a.size());
+  a.clear();
+  EXPECT_TRUE(a.empty());
+}
+
+TEST_F(cow_vector_test, from_vector) {
+  vector<element> items;
+  items.push_back(1);
+  items.push_back(2);
+  const element* data = items.data();
+
+  cow_vector<element> a(std::move(items));
+  EXPECT_EQ(data, a.data());
+  EXPECT_EQ(data, a.items().data());
+}
+
+TEST_F(cow_vector_test, pmr_allocator) {
+  using allocator = std::pmr::polymorphic_allocator<element>;
+  std::pmr::unsynchronized_pool_resource pool;
+  std::pmr::memory_resource* heap = std::pmr::new_delete_resource();
+  allocator from_pool(&pool);
+  allocator from_heap(heap);
+  cow_vector<element, allocator> a({1, 2, 3}, from_pool);
+  cow_vector<element, allocator> b({4}, from_heap);
+  b = a;
+  EXPECT_FALSE(a.is_shared());
+  EXPECT_EQ(heap, b.get_allocator().resource());
+  EXPECT_EQ(heap, b.items().get_allocator().resource());
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(b));
+
+  cow_vector<element, allocator> c(from_pool);
+  c = a;
+  EXPECT_TRUE(a.is_shared());
+  EXPECT_EQ(a.data(), c.data());
+
+  cow_vector<element, allocator> d({5, 6}, from_heap);
+  d = std::move(c);
+  EXPECT_EQ(heap, d.get_allocator().resource());
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(d));
+  d = std::move(a);
+  EXPECT_EQ(heap, d.items().get_allocator().resource());
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(d));
+  b.swap(d);
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(b));
+}
+
+TEST_F(cow_vector_test, mutation_throw) {
+  faulty_run([] {
+    fault_injection_disable dg;
+    cow_vector<element> a = {1, 2, 3};
+    cow_vector<element> b = a;
+    dg.reset();
+
+    try {
+      b.push_back(4);
+    } catch (...) {
+      EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(a));
+      EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(b));
+      throw;
+    }
+  });
+}
+
+TEST_F(cow_vector_test, concurrent_copies) {
+  static constexpr size_t THREADS = 4, K = 10'000;
+
+  cow_vector<std::string> a = {"a", "b", "c"};
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < THREADS; ++i) {
+    threads.emplace_back([&a] {
+      for (size_t j = 0; j < K; ++j) {
+        cow_vector<std::string> snapshot = a;
+        cow_vector<std::string> other = snapshot;
+        other.push_back("d");
+        ASSERT_EQ(3, snapshot.size());
+        ASSERT_EQ(4, other.size());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(a.is_shared());
+}
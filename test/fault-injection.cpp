@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <iostream>
+#include <new>
 #include <vector>
 
 namespace {
@@ -154,6 +155,24 @@ void* operator new[](size_t count) {
   return injected_allocate(count);
 }
 
+// Replaced too, so that the memory is always freed by `free`, even if the sanitizer runtime provides its own nothrow
+// version instead of calling the throwing one
+void* operator new(size_t count, const std::nothrow_t&) noexcept {
+  try {
+    return injected_allocate(count);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void* operator new[](size_t count, const std::nothrow_t&) noexcept {
+  try {
+    return injected_allocate(count);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
 void operator delete(void* ptr) noexcept {
   injected_deallocate(ptr);
 }
@@ -0,0 +1,147 @@
+#include "element.h"
+#include "fault-injection.h"
+#include "flat-map.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+template class flat_map<int, int>;
+template class flat_map<std::string, element>;
+template class flat_map<std::string, element_with_non_throwing_move>;
+
+namespace {
+
+class flat_map_test : public ::testing::Test {
+protected:
+  element::no_new_instances_guard instances_guard;
+};
+
+template <typename K, typename V>
+std::vector<std::pair<K, int>> to_pairs(const flat_map<K, V>& m) {
+  fault_injection_disable dg;
+  std::vector<std::pair<K, int>> result;
+  for (auto [key, value] : m) {
+    result.emplace_back(key, value);
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_F(flat_map_test, insert_and_find) {
+  flat_map<std::string, int> a;
+  EXPECT_TRUE(a.insert({"b", 2}).second);
+  EXPECT_TRUE(a.try_emplace("a", 1).second);
+  EXPECT_FALSE(a.try_emplace("a", 10).second);
+  a["c"] = 3;
+  a["a"] += 10;
+  EXPECT_EQ((std::vector<std::pair<std::string, int>>{{"a", 11}, {"b", 2}, {"c", 3}}), to_pairs(a));
+  EXPECT_EQ((std::vector<std::string>{"a", "b", "c"}), std::vector<std::string>(a.keys().begin(), a.keys().end()));
+
+  EXPECT_EQ(2, a.at("b"));
+  EXPECT_THROW(a.at("d"), std::out_of_range);
+  EXPECT_TRUE(a.contains("c"));
+  EXPECT_EQ(a.end(), a.find("d"));
+  EXPECT_EQ(3, (*a.find("c")).second);
+  (*a.find("c")).second = 30;
+  EXPECT_EQ(30, a.at("c"));
+  EXPECT_EQ(a.begin() + 2, a.lower_bound("bb"));
+
+  EXPECT_FALSE(a.insert_or_assign("b", 20).second);
+  EXPECT_TRUE(a.insert_or_assign("d", 4).second);
+  EXPECT_EQ((std::vector<std::pair<std::string, int>>{{"a", 11}, {"b", 20}, {"c", 30}, {"d", 4}}), to_pairs(a));
+
+  EXPECT_EQ(1, a.erase("b"));
+  EXPECT_EQ(0, a.erase("b"));
+  a.erase(a.begin());
+  EXPECT_EQ((std::vector<std::pair<std::string, int>>{{"c", 30}, {"d", 4}}), to_pairs(a));
+}
+
+TEST_F(flat_map_test, bulk_insert) {
+  flat_map<int, int> a = {{5, 50}, {1, 10}, {5, 51}, {3, 30}};
+  EXPECT_EQ((std::vector<std::pair<int, int>>{{1, 10}, {3, 30}, {5, 50}}), to_pairs(a));
+  std::vector<std::pair<int, int>> more = {{4, 40}, {3, 31}, {0, 0}, {4, 41}, {9, 90}};
+  a.insert(more.begin(), more.end());
+  EXPECT_EQ((std::vector<std::pair<int, int>>{{0, 0}, {1, 10}, {3, 30}, {4, 40}, {5, 50}, {9, 90}}), to_pairs(a));
+
+  vector<int> keys, values;
+  for (int key : {3, 1, 2}) {
+    keys.push_back(key);
+    values.push_back(key * 10);
+  }
+  flat_map<int, int> b(std::move(keys), std::move(values));
+  EXPECT_EQ((std::vector<std::pair<int, int>>{{1, 10}, {2, 20}, {3, 30}}), to_pairs(b));
+}
+
+TEST_F(flat_map_test, bulk_insert_moves_existing) {
+  flat_map<std::string, element_with_non_throwing_move> a;
+  for (int i = 0; i < 100; ++i) {
+    a.try_emplace(std::to_string(2 * i), i);
+  }
+  std::vector<std::pair<std::string, int>> more = {{"51", 51}};
+  element::reset_counters();
+  a.insert(more.begin(), more.end());
+  EXPECT_EQ(0, element::get_copy_counter());
+  EXPECT_EQ(101, a.size());
+  EXPECT_EQ(51, a.at("51"));
+  EXPECT_EQ(49, a.at("98"));
+}
+
+TEST_F(flat_map_test, matches_std_map) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(0, 500);
+  flat_map<int, int> a;
+  std::map<int, int> expected;
+  for (int i = 0; i < 2000; ++i) {
+    int key = dist(gen);
+    if (i % 3 == 0) {
+      EXPECT_EQ(expected.erase(key), a.erase(key));
+    } else {
+      EXPECT_EQ(expected.try_emplace(key, i).second, a.try_emplace(key, i).second);
+    }
+  }
+  EXPECT_EQ((std::vector<std::pair<int, int>>(expected.begin(), expected.end())), to_pairs(a));
+}
+
+TEST_F(flat_map_test, try_emplace_throw) {
+  faulty_run([] {
+    flat_map<std::string, element> a;
+    {
+      fault_injection_disable dg;
+      a.try_emplace("b", 2);
+      a.try_emplace("d", 4);
+    }
+    try {
+      a.try_emplace("c", 3);
+    } catch (...) {
+      fault_injection_disable dg;
+      EXPECT_EQ((std::vector<std::pair<std::string, int>>{{"b", 2}, {"d", 4}}), to_pairs(a));
+      throw;
+    }
+  });
+}
+
+TEST_F(flat_map_test, bulk_insert_throw) {
+  faulty_run([] {
+    flat_map<std::string, element> a;
+    {
+      fault_injection_disable dg;
+      a.try_emplace("b", 2);
+      a.try_emplace("d", 4);
+    }
+    std::vector<std::pair<std::string, int>> more = {{"e", 5}, {"a", 1}, {"b", 3}};
+    try {
+      a.insert(more.begin(), more.end());
+    } catch (...) {
+      fault_injection_disable dg;
+      EXPECT_EQ((std::vector<std::pair<std::string, int>>{{"b", 2}, {"d", 4}}), to_pairs(a));
+      throw;
+    }
+  });
+}
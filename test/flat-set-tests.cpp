@@ -0,0 +1,140 @@
+#include "element.h"
+#include "fault-injection.h"
+#include "flat-set.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+template class flat_set<int>;
+template class flat_set<std::string, std::greater<>>;
+template class flat_set<element>;
+template class flat_set<element_with_non_throwing_move>;
+
+namespace {
+
+template <typename C>
+std::vector<int> to_ints(const C& c) {
+  fault_injection_disable dg;
+  return std::vector<int>(c.begin(), c.end());
+}
+
+} // namespace
+
+TEST(flat_set_test, branchless_lower_bound) {
+  std::vector<int> a;
+  for (int size = 0; size < 40; ++size) {
+    for (int key = -1; key <= 2 * size + 1; ++key) {
+      size_t expected = std::lower_bound(a.begin(), a.end(), key) - a.begin();
+      ASSERT_EQ(expected, detail::branchless_lower_bound(a.data(), a.size(), key, std::less<>()));
+    }
+    a.push_back(2 * size);
+  }
+}
+
+TEST(flat_set_test, insert_and_find) {
+  flat_set<int> a;
+  EXPECT_TRUE(a.insert(5).second);
+  EXPECT_TRUE(a.insert(1).second);
+  EXPECT_TRUE(a.emplace(3).second);
+  std::pair<flat_set<int>::iterator, bool> result = a.insert(3);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(3, *result.first);
+  EXPECT_EQ((std::vector<int>{1, 3, 5}), to_ints(a));
+
+  EXPECT_TRUE(a.contains(1));
+  EXPECT_FALSE(a.contains(2));
+  EXPECT_EQ(a.end(), a.find(4));
+  EXPECT_EQ(a.begin() + 2, a.find(5));
+  EXPECT_EQ(1, a.count(5));
+  EXPECT_EQ(a.begin() + 1, a.lower_bound(3));
+  EXPECT_EQ(a.begin() + 2, a.upper_bound(3));
+  EXPECT_EQ(a.begin(), a.upper_bound(0));
+  EXPECT_EQ(a.end(), a.upper_bound(5));
+
+  EXPECT_EQ(1, a.erase(3));
+  EXPECT_EQ(0, a.erase(3));
+  a.erase(a.begin());
+  EXPECT_EQ((std::vector<int>{5}), to_ints(a));
+}
+
+TEST(flat_set_test, bulk_insert) {
+  flat_set<int> a = {9, 3, 3, 7, 1};
+  EXPECT_EQ((std::vector<int>{1, 3, 7, 9}), to_ints(a));
+  std::vector<int> more = {8, 1, 2, 8, 10, 0};
+  a.insert(more.begin(), more.end());
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 7, 8, 9, 10}), to_ints(a));
+
+  vector<int> keys;
+  for (int key : {4, 2, 4, 0}) {
+    keys.push_back(key);
+  }
+  flat_set<int> b(std::move(keys));
+  EXPECT_EQ((std::vector<int>{0, 2, 4}), to_ints(b));
+  keys = std::move(b).extract();
+  EXPECT_EQ(3, keys.size());
+}
+
+TEST(flat_set_test, bulk_insert_throw) {
+  element::no_new_instances_guard instances_guard;
+  faulty_run([] {
+    flat_set<element> a;
+    {
+      fault_injection_disable dg;
+      a.insert(2);
+      a.insert(4);
+    }
+    std::vector<int> more = {5, 1, 2, 3};
+    try {
+      a.insert(more.begin(), more.end());
+    } catch (...) {
+      fault_injection_disable dg;
+      EXPECT_EQ((std::vector<int>{2, 4}), to_ints(a));
+      throw;
+    }
+    fault_injection_disable dg;
+    EXPECT_EQ((std::vector<int>{1, 2, 3, 4, 5}), to_ints(a));
+  });
+}
+
+TEST(flat_set_test, bulk_insert_moves_existing) {
+  element::no_new_instances_guard instances_guard;
+  flat_set<element_with_non_throwing_move> a;
+  for (int i = 0; i < 100; ++i) {
+    a.insert(2 * i);
+  }
+  std::vector<int> more = {51};
+  element::reset_counters();
+  a.insert(more.begin(), more.end());
+  EXPECT_EQ(0, element::get_copy_counter());
+  EXPECT_EQ(101, a.size());
+}
+
+TEST(flat_set_test, custom_compare) {
+  flat_set<std::string, std::greater<>> a = {"b", "a", "c", "b"};
+  EXPECT_EQ((std::vector<std::string>{"c", "b", "a"}), std::vector<std::string>(a.begin(), a.end()));
+  EXPECT_TRUE(a.contains("a"));
+  EXPECT_EQ(a.begin() + 1, a.lower_bound("b"));
+  EXPECT_EQ(a.begin() + 2, a.upper_bound("b"));
+}
+
+TEST(flat_set_test, matches_std_set) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(0, 1000);
+  flat_set<int> a;
+  std::set<int> expected;
+  for (int i = 0; i < 2000; ++i) {
+    int key = dist(gen);
+    if (i % 3 == 0) {
+      EXPECT_EQ(expected.erase(key), a.erase(key));
+    } else {
+      EXPECT_EQ(expected.insert(key).second, a.insert(key).second);
+    }
+  }
+  EXPECT_EQ(std::vector<int>(expected.begin(), expected.end()), to_ints(a));
+}
@@ -0,0 +1,137 @@
+#include "element.h"
+#include "fault-injection.h"
+#include "inplace-vector.h"
+
+#include <gtest/gtest.h>
+
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+template class inplace_vector<int, 4>;
+template class inplace_vector<element, 8>;
+template class inplace_vector<std::string, 2>;
+
+static_assert(std::is_trivially_copyable_v<inplace_vector<int, 4>>);
+static_assert(std::is_trivially_destructible_v<inplace_vector<int, 4>>);
+static_assert(!std::is_trivially_copyable_v<inplace_vector<std::string, 4>>);
+static_assert(sizeof(inplace_vector<int, 4>) == 4 * sizeof(int) + sizeof(size_t));
+static_assert(std::is_empty_v<detail::inline_storage<int, 0>>);
+static_assert(inplace_vector<int, 0>::capacity() == 0);
+
+namespace {
+
+class inplace_vector_test : public ::testing::Test {
+protected:
+  element::no_new_instances_guard instances_guard;
+};
+
+template <typename C>
+std::vector<int> to_ints(const C& c) {
+  fault_injection_disable dg;
+  return std::vector<int>(c.begin(), c.end());
+}
+
+} // namespace
+
+TEST_F(inplace_vector_test, push_back_until_full) {
+  inplace_vector<element, 8> a;
+  for (int i = 0; i < 8; ++i) {
+    a.push_back(i);
+  }
+  EXPECT_TRUE(a.full());
+  EXPECT_THROW(a.push_back(8), std::bad_alloc);
+  EXPECT_EQ(nullptr, a.try_push_back(8));
+  EXPECT_EQ(8, a.size());
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}), to_ints(a));
+
+  a.pop_back();
+  element* inserted = a.try_emplace_back(10);
+  ASSERT_NE(nullptr, inserted);
+  EXPECT_EQ(&a.back(), inserted);
+  EXPECT_EQ(10, a.back());
+  EXPECT_EQ(0, a.front());
+}
+
+TEST_F(inplace_vector_test, try_push_back_keeps_value) {
+  inplace_vector<std::string, 2> a = {"a", "b"};
+  std::string value(100, 'x');
+  EXPECT_EQ(nullptr, a.try_push_back(std::move(value)));
+  EXPECT_EQ(100, value.size());
+}
+
+TEST_F(inplace_vector_test, insert_erase) {
+  inplace_vector<element, 8> a = {0, 1, 2, 3};
+  a.insert(a.begin() + 1, 10);
+  a.emplace(a.end(), 20);
+  a.insert(a.begin(), a[1]);
+  EXPECT_EQ((std::vector<int>{10, 0, 10, 1, 2, 3, 20}), to_ints(a));
+  a.erase(a.begin() + 1, a.begin() + 3);
+  a.erase(a.begin());
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 20}), to_ints(a));
+  a = {0, 1, 2, 3, 4, 5, 6, 7};
+  EXPECT_THROW(a.insert(a.begin(), 10), std::bad_alloc);
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}), to_ints(a));
+}
+
+TEST_F(inplace_vector_test, resize) {
+  inplace_vector<element, 8> a;
+  a.resize(3, 7);
+  EXPECT_EQ((std::vector<int>{7, 7, 7}), to_ints(a));
+  a.resize(1, 0);
+  EXPECT_EQ((std::vector<int>{7}), to_ints(a));
+  EXPECT_THROW(a.resize(9, 0), std::bad_alloc);
+  EXPECT_EQ(1, a.size());
+
+  inplace_vector<int, 4> b;
+  b.resize(4);
+  EXPECT_EQ((std::vector<int>{0, 0, 0, 0}), to_ints(b));
+}
+
+TEST_F(inplace_vector_test, copy_move_swap) {
+  inplace_vector<element, 8> a = {1, 2, 3};
+  inplace_vector<element, 8> b = a;
+  EXPECT_EQ(a, b);
+  inplace_vector<element, 8> c = {4, 5, 6, 7, 8};
+  c.swap(a);
+  EXPECT_EQ((std::vector<int>{4, 5, 6, 7, 8}), to_ints(a));
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(c));
+  b = std::move(a);
+  EXPECT_EQ((std::vector<int>{4, 5, 6, 7, 8}), to_ints(b));
+  EXPECT_LT(c, b);
+
+  inplace_vector<int, 4> d = {1, 2};
+  inplace_vector<int, 4> e = d;
+  EXPECT_EQ(d, e);
+}
+
+TEST_F(inplace_vector_test, push_back_throw) {
+  faulty_run([] {
+    inplace_vector<element, 8> a;
+    {
+      fault_injection_disable dg;
+      a = {1, 2, 3};
+    }
+    try {
+      a.push_back(4);
+    } catch (...) {
+      fault_injection_disable dg;
+      EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(a));
+      throw;
+    }
+  });
+}
+
+TEST_F(inplace_vector_test, copy_throw) {
+  faulty_run([] {
+    inplace_vector<element, 8> a;
+    {
+      fault_injection_disable dg;
+      a = {1, 2, 3, 4, 5};
+    }
+    inplace_vector<element, 8> b = a;
+    fault_injection_disable dg;
+    EXPECT_EQ(to_ints(a), to_ints(b));
+  });
+}
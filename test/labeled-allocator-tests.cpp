@@ -0,0 +1,134 @@
+#include "element.h"
+#include "fault-injection.h"
+#include "labeled-allocator.h"
+#include "vector.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+
+namespace {
+
+// The hook must not allocate, so the events are recorded into a fixed buffer
+struct recorded_events {
+  static constexpr size_t capacity = 64;
+
+  allocation_event events[capacity];
+  size_t count = 0;
+
+  // Bytes allocated and not yet deallocated with `label`
+  size_t live_bytes(const char* label) const {
+    size_t result = 0;
+    for (size_t i = 0; i < count; ++i) {
+      if (std::strcmp(events[i].label, label) == 0) {
+        result = events[i].allocated ? result + events[i].bytes : result - events[i].bytes;
+      }
+    }
+    return result;
+  }
+};
+
+recorded_events recorded;
+
+void record(const allocation_event& event) noexcept {
+  if (recorded.count < recorded_events::capacity) {
+    recorded.events[recorded.count++] = event;
+  }
+}
+
+class labeled_allocator_test : public ::testing::Test {
+protected:
+  void SetUp() override {
+    recorded.count = 0;
+    previous_hook = set_allocation_hook(record);
+  }
+
+  void TearDown() override {
+    set_allocation_hook(previous_hook);
+  }
+
+  element::no_new_instances_guard instances_guard;
+  allocation_hook previous_hook = nullptr;
+};
+
+template <typename T>
+using labeled_vector = vector<T, labeled_allocator<T>>;
+
+} // namespace
+
+template class vector<int, labeled_allocator<int>>;
+template class vector<element, labeled_allocator<element>>;
+template class vector<std::string, labeled_allocator<std::string>, 2>;
+
+TEST_F(labeled_allocator_test, reports_allocations) {
+  {
+    labeled_vector<int> a(labeled_allocator<int>("requests"));
+    a.reserve(10);
+    ASSERT_EQ(1, recorded.count);
+    EXPECT_STREQ("requests", recorded.events[0].label);
+    EXPECT_EQ(a.data(), recorded.events[0].ptr);
+    EXPECT_EQ(10 * sizeof(int), recorded.events[0].bytes);
+    EXPECT_TRUE(recorded.events[0].allocated);
+    EXPECT_EQ(a.memory_usage().reserved, recorded.live_bytes("requests"));
+  }
+  ASSERT_EQ(2, recorded.count);
+  EXPECT_FALSE(recorded.events[1].allocated);
+  EXPECT_EQ(0, recorded.live_bytes("requests"));
+}
+
+TEST_F(labeled_allocator_test, default_label) {
+  labeled_vector<int> a;
+  a.push_back(1);
+  EXPECT_STREQ("vector", a.get_allocator().label());
+  EXPECT_EQ(sizeof(int), recorded.live_bytes("vector"));
+}
+
+TEST_F(labeled_allocator_test, no_hook) {
+  set_allocation_hook(nullptr);
+  labeled_vector<int> a;
+  a.push_back(1);
+  EXPECT_EQ(0, recorded.count);
+}
+
+TEST_F(labeled_allocator_test, buffer_keeps_label_on_move) {
+  labeled_vector<int> a(labeled_allocator<int>("a"));
+  labeled_vector<int> b(labeled_allocator<int>("b"));
+  a.reserve(4);
+  b.reserve(8);
+  b = std::move(a);
+  EXPECT_STREQ("a", b.get_allocator().label());
+  EXPECT_EQ(0, recorded.live_bytes("b"));
+  EXPECT_EQ(4 * sizeof(int), recorded.live_bytes("a"));
+
+  labeled_vector<int> c(labeled_allocator<int>("c"));
+  c.reserve(2);
+  c.swap(b);
+  EXPECT_STREQ("a", c.get_allocator().label());
+  EXPECT_STREQ("c", b.get_allocator().label());
+}
+
+TEST_F(labeled_allocator_test, copy_keeps_target_label) {
+  labeled_vector<int> a(labeled_allocator<int>("a"));
+  a.push_back(1);
+  labeled_vector<int> b(labeled_allocator<int>("b"));
+  b = a;
+  EXPECT_STREQ("b", b.get_allocator().label());
+  EXPECT_EQ(sizeof(int), recorded.live_bytes("b"));
+}
+
+TEST_F(labeled_allocator_test, push_back_throw) {
+  faulty_run([] {
+    recorded.count = 0;
+    try {
+      labeled_vector<element> a(labeled_allocator<element>("elements"));
+      for (int i = 0; i < 10; ++i) {
+        a.push_back(i);
+      }
+    } catch (...) {
+      EXPECT_EQ(0, recorded.live_bytes("elements"));
+      throw;
+    }
+    EXPECT_EQ(0, recorded.live_bytes("elements"));
+  });
+}
@@ -0,0 +1,128 @@
+#if defined(__unix__) || defined(__APPLE__)
+
+#include "mmap-vector.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+namespace {
+
+class mmap_vector_test : public ::testing::Test {
+protected:
+  void SetUp() override {
+    path = std::filesystem::temp_directory_path() /
+           ("mmap-vector-" + std::to_string(::getpid()) + "-" +
+            ::testing::UnitTest::GetInstance()->current_test_info()->name());
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(path);
+  }
+
+  std::filesystem::path path;
+};
+
+} // namespace
+
+TEST_F(mmap_vector_test, push_back) {
+  static constexpr size_t N = 100'000;
+
+  mmap_vector<uint64_t> a = mmap_vector<uint64_t>::create(path.c_str());
+  EXPECT_TRUE(a.empty());
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(i * i);
+  }
+  ASSERT_EQ(N, a.size());
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(i * i, a[i]);
+  }
+  a.push_back(a[0]);
+  EXPECT_EQ(0, a.back());
+}
+
+TEST_F(mmap_vector_test, reopen) {
+  static constexpr size_t N = 10'000;
+
+  {
+    mmap_vector<uint64_t> a = mmap_vector<uint64_t>::create(path.c_str());
+    for (size_t i = 0; i < N; ++i) {
+      a.push_back(i + 1);
+    }
+    a.sync();
+  }
+
+  mmap_vector<uint64_t> b = mmap_vector<uint64_t>::open(path.c_str());
+  ASSERT_EQ(N, b.size());
+  EXPECT_GE(b.capacity(), N);
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(i + 1, b[i]);
+  }
+
+  b.pop_back();
+  b.shrink_to_fit();
+  EXPECT_EQ(N - 1, b.capacity());
+  EXPECT_EQ(N - 1, mmap_vector<uint64_t>::open(path.c_str()).size());
+}
+
+TEST_F(mmap_vector_test, resize_reserve) {
+  mmap_vector<int> a = mmap_vector<int>::create(path.c_str());
+  a.reserve(1000);
+  EXPECT_EQ(1000, a.capacity());
+  EXPECT_EQ(0, a.size());
+
+  a.resize(10);
+  for (int x : a) {
+    EXPECT_EQ(0, x);
+  }
+  a[3] = 42;
+  a.resize(2000);
+  EXPECT_EQ(42, a[3]);
+  EXPECT_EQ(0, a[1999]);
+
+  a.clear();
+  EXPECT_TRUE(a.empty());
+  a.resize(5);
+  EXPECT_EQ(0, a[3]);
+}
+
+TEST_F(mmap_vector_test, move) {
+  mmap_vector<int> a = mmap_vector<int>::create(path.c_str());
+  a.push_back(1);
+  mmap_vector<int> b = std::move(a);
+  EXPECT_EQ(1, b.size());
+  a = std::move(b);
+  EXPECT_EQ(1, a[0]);
+}
+
+TEST_F(mmap_vector_test, moved_from) {
+  mmap_vector<int> a = mmap_vector<int>::create(path.c_str());
+  a.push_back(1);
+  mmap_vector<int> b = std::move(a);
+  EXPECT_EQ(0, a.size());
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ(a.begin(), a.end());
+  a.clear();
+  a.resize(0);
+  a.shrink_to_fit();
+  a.sync();
+  EXPECT_THROW(a.push_back(2), std::system_error);
+  EXPECT_THROW(a.reserve(10), std::system_error);
+  EXPECT_EQ(0, a.size());
+
+  a = mmap_vector<int>::open(path.c_str());
+  EXPECT_EQ(1, a.size());
+  EXPECT_EQ(1, a[0]);
+}
+
+TEST_F(mmap_vector_test, open_errors) {
+  EXPECT_THROW(mmap_vector<int>::open(path.c_str()), std::system_error);
+
+  mmap_vector<int>::create(path.c_str()).push_back(1);
+  EXPECT_THROW(mmap_vector<uint64_t>::open(path.c_str()), std::system_error);
+}
+
+#endif
@@ -0,0 +1,128 @@
+#include "element.h"
+#include "fault-injection.h"
+#include "pool-allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class pool_allocator_test : public ::testing::Test {
+protected:
+  void SetUp() override {
+    buffer_pool::trim();
+    buffer_pool::reset_stats();
+  }
+
+  void TearDown() override {
+    buffer_pool::set_retention_limit(retention_limit);
+    buffer_pool::trim();
+  }
+
+  element::no_new_instances_guard instances_guard;
+  size_t retention_limit = buffer_pool::retention_limit();
+};
+
+} // namespace
+
+template class vector<int, pool_allocator<int>, 0, pool_growth<>>;
+template class vector<element, pool_allocator<element>, 0, pool_growth<>>;
+template class vector<std::string, pool_allocator<std::string>, 0, pool_growth<>>;
+
+static_assert(pool_growth<>::grow(0, 1, sizeof(int)) == 4);
+static_assert(pool_growth<>::grow(4, 5, sizeof(int)) == 8);
+static_assert(pool_growth<>::grow(0, 3, 12) == 5);
+static_assert(pool_growth<>::grow(0, buffer_pool::max_pooled_bytes + 1, 1) == buffer_pool::max_pooled_bytes + 1);
+
+TEST_F(pool_allocator_test, reuses_released_buffer) {
+  const int* data;
+  {
+    pooled_vector<int> a;
+    a.reserve(100);
+    data = a.data();
+  }
+  EXPECT_EQ((buffer_pool_stats{0, 1, 1, 0, 512}), buffer_pool::stats());
+
+  pooled_vector<int> b;
+  for (int i = 0; i < 100; ++i) {
+    b.push_back(i);
+  }
+  EXPECT_EQ(data, b.data());
+  EXPECT_EQ(128, b.capacity());
+  // Only the last reallocation finds a buffer, the smaller ones left behind while growing stay in the pool
+  EXPECT_EQ(1, buffer_pool::stats().hits);
+}
+
+TEST_F(pool_allocator_test, shrink_to_fit_returns_buffer) {
+  pooled_vector<std::string> a;
+  a.reserve(64);
+  a.push_back("a");
+  a.shrink_to_fit();
+  EXPECT_EQ(1, buffer_pool::stats().recycled);
+  EXPECT_EQ(64 * sizeof(std::string), buffer_pool::stats().retained_bytes);
+
+  pooled_vector<std::string> b;
+  b.reserve(60);
+  EXPECT_EQ(1, buffer_pool::stats().hits);
+}
+
+TEST_F(pool_allocator_test, retention_limit) {
+  buffer_pool::set_retention_limit(200);
+  {
+    pooled_vector<int> a;
+    a.reserve(32);
+    pooled_vector<int> b;
+    b.reserve(32);
+    pooled_vector<int> c;
+    c.reserve(1000);
+  }
+  buffer_pool_stats stats = buffer_pool::stats();
+  EXPECT_EQ(1, stats.recycled);
+  EXPECT_EQ(2, stats.released);
+  EXPECT_EQ(128, stats.retained_bytes);
+}
+
+TEST_F(pool_allocator_test, large_buffers_are_not_pooled) {
+  {
+    pooled_vector<char> a;
+    a.reserve(buffer_pool::max_pooled_bytes + 1);
+  }
+  EXPECT_EQ(1, buffer_pool::stats().released);
+  EXPECT_EQ(0, buffer_pool::stats().retained_bytes);
+}
+
+TEST_F(pool_allocator_test, trim) {
+  {
+    pooled_vector<int> a;
+    a.reserve(10);
+  }
+  EXPECT_NE(0, buffer_pool::stats().retained_bytes);
+  buffer_pool::trim();
+  EXPECT_EQ(0, buffer_pool::stats().retained_bytes);
+}
+
+TEST_F(pool_allocator_test, deallocate_in_other_thread) {
+  pooled_vector<int> a;
+  a.reserve(10);
+  std::thread([a = std::move(a)]() mutable {
+    a = {};
+    EXPECT_EQ(1, buffer_pool::stats().recycled);
+  }).join();
+  EXPECT_EQ(0, buffer_pool::stats().recycled);
+  EXPECT_EQ(0, buffer_pool::stats().retained_bytes);
+}
+
+TEST_F(pool_allocator_test, push_back_throw) {
+  faulty_run([] {
+    pooled_vector<element> a;
+    for (int i = 0; i < 20; ++i) {
+      a.push_back(i);
+    }
+    pooled_vector<element> b = a;
+    fault_injection_disable dg;
+    EXPECT_EQ(a, b);
+  });
+}
@@ -0,0 +1,292 @@
+#include "element.h"
+#include "fault-injection.h"
+#include "segmented-vector.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+class segmented_vector_test : public ::testing::Test {
+protected:
+  element::no_new_instances_guard instances_guard;
+};
+
+template <typename C>
+std::vector<int> to_ints(const C& c) {
+  fault_injection_disable dg;
+  return std::vector<int>(c.begin(), c.end());
+}
+
+template <typename T, bool Propagate>
+struct tagged_allocator {
+  using value_type = T;
+
+  using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+  using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+  using propagate_on_container_swap = std::bool_constant<Propagate>;
+
+  template <typename U>
+  struct rebind {
+    using other = tagged_allocator<U, Propagate>;
+  };
+
+  explicit tagged_allocator(int tag) noexcept
+      : tag(tag) {}
+
+  template <typename U>
+  tagged_allocator(const tagged_allocator<U, Propagate>& other) noexcept
+      : tag(other.tag) {}
+
+  T* allocate(size_t count) {
+    return std::allocator<T>().allocate(count);
+  }
+
+  void deallocate(T* ptr, size_t count) noexcept {
+    std::allocator<T>().deallocate(ptr, count);
+  }
+
+  template <typename U>
+  friend bool operator==(const tagged_allocator& lhs, const tagged_allocator<U, Propagate>& rhs) noexcept {
+    return lhs.tag == rhs.tag;
+  }
+
+  int tag;
+};
+
+} // namespace
+
+template class segmented_vector<int>;
+template class segmented_vector<element>;
+template class segmented_vector<element, tagged_allocator<element, false>>;
+template class segmented_vector<element, tagged_allocator<element, true>>;
+template class segmented_vector<element, std::pmr::polymorphic_allocator<element>>;
+
+static_assert(std::random_access_iterator<segmented_vector<int>::iterator>);
+static_assert(std::random_access_iterator<segmented_vector<int>::const_iterator>);
+
+TEST_F(segmented_vector_test, push_back_keeps_references) {
+  static constexpr size_t N = 5'000;
+
+  segmented_vector<element> a;
+  std::vector<const element*> addresses;
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(static_cast<int>(i));
+    addresses.push_back(&a.back());
+  }
+
+  element::reset_counters();
+  a.emplace_back(-1);
+  EXPECT_EQ(0, element::get_copy_counter());
+  EXPECT_EQ(0, element::get_move_counter());
+  a.pop_back();
+
+  ASSERT_EQ(N, a.size());
+  EXPECT_GE(a.capacity(), N);
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(i, a[i]);
+    ASSERT_EQ(addresses[i], &a[i]);
+  }
+}
+
+TEST_F(segmented_vector_test, iterators) {
+  segmented_vector<int> a;
+  for (int i = 0; i < 1000; ++i) {
+    a.push_back(999 - i);
+  }
+  auto it = a.begin();
+  a.push_back(-1);
+  EXPECT_EQ(999, *it);
+  a.pop_back();
+
+  std::sort(a.begin(), a.end());
+  EXPECT_TRUE(std::is_sorted(a.begin(), a.end()));
+  EXPECT_EQ(1000, a.end() - a.begin());
+  EXPECT_EQ(499500, std::accumulate(a.begin(), a.end(), 0));
+
+  const segmented_vector<int>& c = a;
+  segmented_vector<int>::const_iterator cit = a.begin() + 10;
+  EXPECT_EQ(cit, c.begin() + 10);
+  EXPECT_EQ(10, *cit);
+  EXPECT_EQ(10, c.begin()[10]);
+}
+
+TEST_F(segmented_vector_test, copy_and_move) {
+  segmented_vector<element> a = {1, 2, 3};
+  segmented_vector<element> b = a;
+  EXPECT_EQ(to_ints(a), to_ints(b));
+
+  segmented_vector<element> c = std::move(a);
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ(to_ints(b), to_ints(c));
+
+  a = c;
+  c.push_back(4);
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(a));
+  b = std::move(c);
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 4}), to_ints(b));
+}
+
+TEST_F(segmented_vector_test, propagating_allocator) {
+  using allocator = tagged_allocator<element, true>;
+  segmented_vector<element, allocator> a({1, 2, 3}, allocator(1));
+  segmented_vector<element, allocator> b({4, 5}, allocator(2));
+  a.swap(b);
+  EXPECT_EQ(2, a.get_allocator().tag);
+  EXPECT_EQ(1, b.get_allocator().tag);
+  EXPECT_EQ((std::vector<int>{4, 5}), to_ints(a));
+
+  segmented_vector<element, allocator> c({6}, allocator(3));
+  c = b;
+  EXPECT_EQ(1, c.get_allocator().tag);
+  c = std::move(a);
+  EXPECT_EQ(2, c.get_allocator().tag);
+  EXPECT_EQ((std::vector<int>{4, 5}), to_ints(c));
+}
+
+TEST_F(segmented_vector_test, non_propagating_allocator) {
+  using allocator = tagged_allocator<element, false>;
+  segmented_vector<element, allocator> a({1, 2, 3}, allocator(1));
+  segmented_vector<element, allocator> b({4, 5}, allocator(1));
+  a.swap(b);
+  EXPECT_EQ((std::vector<int>{4, 5}), to_ints(a));
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(b));
+
+  segmented_vector<element, allocator> c({6}, allocator(2));
+  c = b;
+  EXPECT_EQ(2, c.get_allocator().tag);
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(c));
+  c = std::move(a);
+  EXPECT_EQ(2, c.get_allocator().tag);
+  EXPECT_EQ((std::vector<int>{4, 5}), to_ints(c));
+}
+
+TEST_F(segmented_vector_test, pmr_allocator) {
+  using allocator = std::pmr::polymorphic_allocator<element>;
+  std::pmr::unsynchronized_pool_resource pool;
+  std::pmr::memory_resource* heap = std::pmr::new_delete_resource();
+  allocator from_pool(&pool);
+  allocator from_heap(heap);
+  segmented_vector<element, allocator> a({1, 2, 3}, from_pool);
+  segmented_vector<element, allocator> b({4}, from_heap);
+  b = a;
+  EXPECT_EQ(heap, b.get_allocator().resource());
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(b));
+
+  segmented_vector<element, allocator> c(from_pool);
+  c = std::move(a);
+  EXPECT_EQ(&pool, c.get_allocator().resource());
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(c));
+
+  segmented_vector<element, allocator> d({5, 6}, from_heap);
+  b = std::move(c);
+  EXPECT_EQ(heap, b.get_allocator().resource());
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(b));
+  b.swap(d);
+  EXPECT_EQ((std::vector<int>{5, 6}), to_ints(b));
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), to_ints(d));
+}
+
+TEST_F(segmented_vector_test, insert_erase) {
+  segmented_vector<element> a = {1, 2, 4};
+  EXPECT_EQ(3, *a.insert(a.begin() + 2, 3));
+  EXPECT_EQ(0, *a.insert(a.begin(), 0));
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4}), to_ints(a));
+
+  EXPECT_EQ(2, *a.erase(a.begin() + 1));
+  EXPECT_EQ(a.end(), a.erase(a.begin() + 2, a.end()));
+  EXPECT_EQ((std::vector<int>{0, 2}), to_ints(a));
+}
+
+TEST_F(segmented_vector_test, resize_reserve) {
+  segmented_vector<int> a;
+  a.reserve(100);
+  EXPECT_GE(a.capacity(), 100);
+  EXPECT_TRUE(a.empty());
+
+  a.resize(50);
+  EXPECT_EQ(50, a.size());
+  EXPECT_EQ(0, a[49]);
+  a.resize(60, 7);
+  EXPECT_EQ(7, a[59]);
+  a.resize(10);
+  EXPECT_EQ(10, a.size());
+
+  a.shrink_to_fit();
+  EXPECT_GE(a.capacity(), 10);
+  EXPECT_LT(a.capacity(), 100);
+
+  a.clear();
+  a.shrink_to_fit();
+  EXPECT_EQ(0, a.capacity());
+}
+
+TEST_F(segmented_vector_test, push_back_throw) {
+  faulty_run([] {
+    segmented_vector<element> a;
+    {
+      fault_injection_disable dg;
+      for (int i = 0; i < 40; ++i) {
+        a.push_back(i);
+      }
+    }
+    try {
+      a.push_back(40);
+    } catch (...) {
+      fault_injection_disable dg;
+      EXPECT_EQ(40, a.size());
+      EXPECT_EQ(39, a.back());
+      throw;
+    }
+  });
+}
+
+TEST_F(segmented_vector_test, copy_throw) {
+  faulty_run([] {
+    segmented_vector<element> a;
+    {
+      fault_injection_disable dg;
+      for (int i = 0; i < 100; ++i) {
+        a.push_back(i);
+      }
+    }
+    segmented_vector<element> b = a;
+    fault_injection_disable dg;
+    EXPECT_EQ(to_ints(a), to_ints(b));
+  });
+}
+
+TEST_F(segmented_vector_test, resize_throw) {
+  faulty_run([] {
+    segmented_vector<element> a;
+    {
+      fault_injection_disable dg;
+      a.push_back(1);
+    }
+    try {
+      a.resize(100, 2);
+    } catch (...) {
+      fault_injection_disable dg;
+      EXPECT_EQ((std::vector<int>{1}), to_ints(a));
+      throw;
+    }
+  });
+}
+
+#ifdef VECTOR_CHECKED
+
+TEST(segmented_vector_death_test, swap_unequal_allocators) {
+  using allocator = tagged_allocator<int, false>;
+  segmented_vector<int, allocator> a(allocator(1));
+  segmented_vector<int, allocator> b(allocator(2));
+  EXPECT_DEATH(a.swap(b), "swapping vectors with unequal allocators");
+}
+
+#endif
@@ -0,0 +1,136 @@
+#include "element.h"
+#include "fault-injection.h"
+#include "pool-allocator.h"
+#include "shrink-policy.h"
+#include "vector.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+class shrink_policy_test : public ::testing::Test {
+protected:
+  element::no_new_instances_guard instances_guard;
+};
+
+template <typename Vector>
+void fill(Vector& v, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    v.push_back(static_cast<int>(i));
+  }
+}
+
+} // namespace
+
+TEST_F(shrink_policy_test, keep_capacity) {
+  vector<element> a;
+  fill(a, 100);
+  size_t capacity = a.capacity();
+  keep_capacity::reset(a);
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ(capacity, a.capacity());
+}
+
+TEST_F(shrink_policy_test, steady_state_keeps_buffer) {
+  high_water_mark_shrink<4> policy;
+  vector<element> a;
+  fill(a, 100);
+  policy.reset(a);
+  const element* data = a.data();
+  for (int cycle = 0; cycle < 20; ++cycle) {
+    fill(a, 40 + cycle % 3 * 30);
+    policy.reset(a);
+    ASSERT_EQ(data, a.data());
+    ASSERT_EQ(0, policy.underused_cycles());
+  }
+}
+
+TEST_F(shrink_policy_test, trims_after_underused_cycles) {
+  high_water_mark_shrink<3> policy;
+  vector<element> a;
+  fill(a, 1000);
+  policy.reset(a);
+  size_t capacity = a.capacity();
+
+  fill(a, 10);
+  policy.reset(a);
+  fill(a, 30);
+  policy.reset(a);
+  EXPECT_EQ(2, policy.underused_cycles());
+  EXPECT_EQ(capacity, a.capacity());
+
+  fill(a, 20);
+  policy.reset(a);
+  EXPECT_EQ(0, policy.underused_cycles());
+  EXPECT_EQ(30, a.capacity());
+  EXPECT_TRUE(a.empty());
+}
+
+TEST_F(shrink_policy_test, used_cycle_starts_count_over) {
+  high_water_mark_shrink<2> policy;
+  vector<element> a;
+  fill(a, 100);
+  policy.reset(a);
+  size_t capacity = a.capacity();
+
+  fill(a, 10);
+  policy.reset(a);
+  fill(a, 90);
+  policy.reset(a);
+  fill(a, 10);
+  policy.reset(a);
+  EXPECT_EQ(1, policy.underused_cycles());
+  EXPECT_EQ(capacity, a.capacity());
+}
+
+TEST_F(shrink_policy_test, inline_storage) {
+  high_water_mark_shrink<1> policy;
+  vector<element, std::allocator<element>, 8> a;
+  fill(a, 4);
+  policy.reset(a);
+  EXPECT_EQ(8, a.capacity());
+
+  fill(a, 100);
+  policy.reset(a);
+  fill(a, 2);
+  policy.reset(a);
+  EXPECT_EQ(8, a.capacity());
+}
+
+TEST_F(shrink_policy_test, pooled_batches_dont_allocate) {
+  buffer_pool::trim();
+  high_water_mark_shrink<> policy;
+  pooled_vector<int> a;
+  for (int cycle = 0; cycle < 3; ++cycle) {
+    fill(a, 500);
+    policy.reset(a);
+  }
+  buffer_pool::reset_stats();
+  for (int cycle = 0; cycle < 100; ++cycle) {
+    fill(a, 300 + cycle % 2 * 200);
+    policy.reset(a);
+  }
+  EXPECT_EQ(0, buffer_pool::stats().misses);
+  EXPECT_EQ(0, buffer_pool::stats().hits);
+}
+
+TEST_F(shrink_policy_test, trim_throw) {
+  faulty_run([] {
+    high_water_mark_shrink<1> policy;
+    vector<element> a;
+    {
+      fault_injection_disable dg;
+      fill(a, 100);
+      policy.reset(a);
+      fill(a, 10);
+    }
+    try {
+      policy.reset(a);
+    } catch (...) {
+      fault_injection_disable dg;
+      EXPECT_TRUE(a.empty());
+      EXPECT_EQ(0, policy.underused_cycles());
+      throw;
+    }
+  });
+}
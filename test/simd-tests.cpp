@@ -0,0 +1,117 @@
+#include "simd.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<size_t> available_widths() {
+  std::vector<size_t> result = {0};
+  for (size_t width = 16; width <= detail::simd::width(); width *= 2) {
+    result.push_back(width);
+  }
+  return result;
+}
+
+// Compares every kernel with the scalar algorithms on arrays of all sizes up to a few registers, at every
+// offset from an aligned address, with a few distinct values so that matches are frequent
+template <typename T>
+void check_kernels() {
+  std::mt19937 rng(42);
+  std::vector<T> buffer(300), other(300);
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    buffer[i] = static_cast<T>(rng() % 5);
+  }
+
+  for (size_t width : available_widths()) {
+    for (size_t offset = 0; offset < 4; ++offset) {
+      for (size_t count = 0; count + offset <= 260; ++count) {
+        const T* data = buffer.data() + offset;
+        for (int v = 0; v < 6; ++v) {
+          T value = static_cast<T>(v);
+          ASSERT_EQ(std::find(data, data + count, value) - data, detail::simd::find(data, count, value, width));
+          ASSERT_EQ(std::count(data, data + count, value), detail::simd::count(data, count, value, width));
+        }
+        ASSERT_EQ(std::min_element(data, data + count) - data, detail::simd::extremum<false>(data, count, width));
+        ASSERT_EQ(std::max_element(data, data + count) - data, detail::simd::extremum<true>(data, count, width));
+
+        std::copy(data, data + count, other.begin());
+        ASSERT_EQ(count, detail::simd::mismatch(data, other.data(), count, width));
+        ASSERT_TRUE(detail::simd::equal(data, other.data(), count, width));
+        if (count != 0) {
+          size_t changed = rng() % count;
+          other[changed] = static_cast<T>(other[changed] + 1);
+          ASSERT_EQ(changed, detail::simd::mismatch(data, other.data(), count, width));
+          ASSERT_FALSE(detail::simd::equal(data, other.data(), count, width));
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+TEST(simd_test, kernels_int8) {
+  check_kernels<int8_t>();
+  check_kernels<uint8_t>();
+  check_kernels<char>();
+}
+
+TEST(simd_test, kernels_int16) {
+  check_kernels<int16_t>();
+  check_kernels<uint16_t>();
+}
+
+TEST(simd_test, kernels_int32) {
+  check_kernels<int32_t>();
+  check_kernels<uint32_t>();
+}
+
+TEST(simd_test, kernels_int64) {
+  check_kernels<int64_t>();
+  check_kernels<uint64_t>();
+}
+
+TEST(simd_test, kernels_floating_point) {
+  check_kernels<float>();
+  check_kernels<double>();
+}
+
+TEST(simd_test, count_does_not_overflow) {
+  std::vector<uint8_t> data(100'000, 7);
+  for (size_t width : available_widths()) {
+    EXPECT_EQ(data.size(), detail::simd::count(data.data(), data.size(), uint8_t(7), width));
+  }
+}
+
+TEST(simd_test, extremes) {
+  std::vector<int32_t> data(1000, 0);
+  data[777] = std::numeric_limits<int32_t>::min();
+  data[778] = std::numeric_limits<int32_t>::min();
+  data[3] = std::numeric_limits<int32_t>::max();
+  for (size_t width : available_widths()) {
+    EXPECT_EQ(777, detail::simd::extremum<false>(data.data(), data.size(), width));
+    EXPECT_EQ(3, detail::simd::extremum<true>(data.data(), data.size(), width));
+  }
+}
+
+TEST(simd_test, floating_point_comparison) {
+  std::vector<double> lhs = {0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0};
+  std::vector<double> rhs = lhs;
+  rhs[0] = -0.0;
+  for (size_t width : available_widths()) {
+    EXPECT_TRUE(detail::simd::equal(lhs.data(), rhs.data(), lhs.size(), width));
+    EXPECT_EQ(0, detail::simd::find(lhs.data(), lhs.size(), -0.0, width));
+  }
+  rhs[8] = std::numeric_limits<double>::quiet_NaN();
+  lhs[8] = rhs[8];
+  for (size_t width : available_widths()) {
+    EXPECT_FALSE(detail::simd::equal(lhs.data(), rhs.data(), lhs.size(), width));
+    EXPECT_EQ(8, detail::simd::mismatch(lhs.data(), rhs.data(), lhs.size(), width));
+  }
+}
@@ -0,0 +1,218 @@
+#include "element.h"
+#include "fault-injection.h"
+#include "soa-vector.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+
+class soa_vector_test : public ::testing::Test {
+protected:
+  element::no_new_instances_guard instances_guard;
+};
+
+template <size_t I, typename C>
+std::vector<int> column_ints(const C& c) {
+  fault_injection_disable dg;
+  auto column = c.template column<I>();
+  return std::vector<int>(column.begin(), column.end());
+}
+
+// Records its value in `log` when destroyed
+template <int Column>
+struct logged_destruction {
+  static inline std::vector<int>* log = nullptr;
+
+  logged_destruction(int value) noexcept
+      : value(value) {}
+
+  logged_destruction(const logged_destruction&) = default;
+
+  ~logged_destruction() {
+    if (log != nullptr) {
+      log->push_back(Column * 10 + value);
+    }
+  }
+
+  int value;
+};
+
+} // namespace
+
+template class soa_vector<int>;
+template class soa_vector<int, double, std::string>;
+template class soa_vector<element, int>;
+
+TEST_F(soa_vector_test, push_back_and_columns) {
+  static constexpr size_t N = 1000;
+
+  soa_vector<int, double, std::string> a;
+  EXPECT_TRUE(a.empty());
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(static_cast<int>(i), i * 0.5, std::to_string(i));
+  }
+  ASSERT_EQ(N, a.size());
+  EXPECT_GE(a.capacity(), N);
+
+  auto ints = a.column<0>();
+  EXPECT_EQ(N, ints.size());
+  EXPECT_EQ(N * (N - 1) / 2, std::accumulate(ints.begin(), ints.end(), size_t(0)));
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(a.column<1>().data()) % 64);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(a.column<2>().data()) % 64);
+
+  for (size_t i = 0; i < N; ++i) {
+    auto [x, y, s] = a[i];
+    ASSERT_EQ(i, x);
+    ASSERT_EQ(i * 0.5, y);
+    ASSERT_EQ(std::to_string(i), s);
+  }
+
+  std::get<0>(a.front()) = -1;
+  EXPECT_EQ(-1, a.column<0>()[0]);
+  EXPECT_EQ("999", std::get<2>(a.back()));
+
+  a.pop_back();
+  EXPECT_EQ(N - 1, a.size());
+  a.clear();
+  EXPECT_TRUE(a.empty());
+}
+
+TEST_F(soa_vector_test, iterators) {
+  soa_vector<int, std::string> a;
+  a.push_back(1, "a");
+  a.push_back(2, "b");
+  a.emplace_back(3, "c");
+
+  std::string joined;
+  int sum = 0;
+  for (auto [x, s] : a) {
+    sum += x;
+    joined += s;
+    s += "!";
+  }
+  EXPECT_EQ(6, sum);
+  EXPECT_EQ("abc", joined);
+  EXPECT_EQ("a!", std::get<1>(a[0]));
+
+  const auto& c = a;
+  soa_vector<int, std::string>::const_iterator it = a.begin();
+  EXPECT_EQ(c.begin(), it);
+  EXPECT_EQ(3, c.end() - it);
+  EXPECT_EQ(2, std::get<0>(it[1]));
+}
+
+TEST_F(soa_vector_test, copy_move_reserve) {
+  soa_vector<element, int> a;
+  for (int i = 0; i < 10; ++i) {
+    a.push_back(i, -i);
+  }
+  soa_vector<element, int> b = a;
+  EXPECT_EQ(column_ints<0>(a), column_ints<0>(b));
+  EXPECT_EQ(column_ints<1>(a), column_ints<1>(b));
+
+  soa_vector<element, int> c = std::move(a);
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ(column_ints<1>(b), column_ints<1>(c));
+
+  c.reserve(100);
+  EXPECT_EQ(100, c.capacity());
+  EXPECT_EQ(column_ints<0>(b), column_ints<0>(c));
+  c.shrink_to_fit();
+  EXPECT_EQ(10, c.capacity());
+
+  a = c;
+  b = std::move(c);
+  EXPECT_EQ(column_ints<0>(a), column_ints<0>(b));
+}
+
+TEST_F(soa_vector_test, push_back_element_of_itself) {
+  soa_vector<element, int> a;
+  a.push_back(1, 2);
+  for (int i = 0; i < 10; ++i) {
+    auto [x, y] = a.back();
+    a.push_back(x, y);
+  }
+  EXPECT_EQ(std::vector<int>(11, 1), column_ints<0>(a));
+  EXPECT_EQ(std::vector<int>(11, 2), column_ints<1>(a));
+}
+
+TEST_F(soa_vector_test, clear_destroys_in_reverse) {
+  std::vector<int> log;
+  soa_vector<logged_destruction<1>, logged_destruction<2>> a;
+  a.reserve(3);
+  for (int i = 0; i < 3; ++i) {
+    a.push_back(i, i);
+  }
+  logged_destruction<1>::log = &log;
+  logged_destruction<2>::log = &log;
+  a.clear();
+  logged_destruction<1>::log = nullptr;
+  logged_destruction<2>::log = nullptr;
+  EXPECT_EQ((std::vector<int>{22, 21, 20, 12, 11, 10}), log);
+}
+
+TEST_F(soa_vector_test, push_back_throw) {
+  faulty_run([] {
+    soa_vector<int, element, element> a;
+    {
+      fault_injection_disable dg;
+      for (int i = 0; i < 8; ++i) {
+        a.push_back(i, i, -i);
+      }
+      a.shrink_to_fit();
+    }
+    try {
+      a.push_back(8, 8, -8);
+    } catch (...) {
+      fault_injection_disable dg;
+      EXPECT_EQ(8, a.size());
+      EXPECT_EQ(8, a.capacity());
+      EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}), column_ints<1>(a));
+      EXPECT_EQ((std::vector<int>{0, -1, -2, -3, -4, -5, -6, -7}), column_ints<2>(a));
+      throw;
+    }
+  });
+}
+
+TEST_F(soa_vector_test, push_back_throw_mixed_columns) {
+  faulty_run([] {
+    soa_vector<std::string, element> a;
+    {
+      fault_injection_disable dg;
+      for (int i = 0; i < 8; ++i) {
+        a.push_back(std::to_string(i), i);
+      }
+      a.shrink_to_fit();
+    }
+    try {
+      a.push_back("8", 8);
+    } catch (...) {
+      fault_injection_disable dg;
+      auto names = a.column<0>();
+      std::vector<std::string> expected = {"0", "1", "2", "3", "4", "5", "6", "7"};
+      EXPECT_EQ(expected, std::vector<std::string>(names.begin(), names.end()));
+      EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}), column_ints<1>(a));
+      throw;
+    }
+  });
+}
+
+TEST_F(soa_vector_test, copy_throw) {
+  faulty_run([] {
+    soa_vector<element, element> a;
+    {
+      fault_injection_disable dg;
+      for (int i = 0; i < 5; ++i) {
+        a.push_back(i, i * 2);
+      }
+    }
+    soa_vector<element, element> b = a;
+    fault_injection_disable dg;
+    EXPECT_EQ(column_ints<1>(a), column_ints<1>(b));
+  });
+}
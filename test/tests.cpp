@@ -1,17 +1,71 @@
+#include "aligned-vector.h"
 #include "element.h"
 #include "fault-injection.h"
+#include "malloc-allocator.h"
 #include "ordered-element.h"
 #include "vector.h"
 
 #include <gtest/gtest.h>
 
+#include <array>
+#include <atomic>
+#include <compare>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
 #include <sstream>
 #include <string>
+#include <string_view>
+
+namespace {
+
+template <typename T, bool Propagate>
+struct tagged_allocator {
+  using value_type = T;
+
+  using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+  using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+  using propagate_on_container_swap = std::bool_constant<Propagate>;
+
+  explicit tagged_allocator(int tag) noexcept
+      : tag(tag) {}
+
+  T* allocate(size_t count) {
+    return std::allocator<T>().allocate(count);
+  }
+
+  void deallocate(T* ptr, size_t count) noexcept {
+    std::allocator<T>().deallocate(ptr, count);
+  }
+
+  friend bool operator==(const tagged_allocator&, const tagged_allocator&) = default;
+
+  int tag;
+};
+
+} // namespace
 
 template class vector<int>;
 template class vector<element>;
 template class vector<std::string>;
 template class vector<ordered_element>;
+template class vector<element, tagged_allocator<element, false>>;
+template class vector<element, tagged_allocator<element, true>>;
+template class vector<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>>;
+template class vector<int, std::allocator<int>, 8>;
+template class vector<element, std::allocator<element>, 4>;
+template class vector<std::string, std::allocator<std::string>, 4>;
+template class vector<ordered_element, std::allocator<ordered_element>, 2>;
+template class vector<element, std::allocator<element>, 0, one_and_a_half_growth>;
+template class vector<int, std::allocator<int>, 0, page_rounding_growth<>>;
+template class vector<int, std::allocator<int>, 0, size_class_growth<>>;
+template class vector<float, aligned_allocator<float, 32>>;
+template class vector<element, aligned_allocator<element, 64>>;
+template class vector<int, malloc_allocator<int>>;
 
 namespace {
 
@@ -114,6 +168,63 @@ protected:
   element::no_new_instances_guard instances_guard;
 };
 
+// Thread-safe element that counts its instances, and throws on a chosen copy
+struct counted_element {
+  explicit counted_element(int value)
+      : value(value) {
+    ++instances;
+  }
+
+  counted_element(const counted_element& other)
+      : value(other.value) {
+    if (copies_until_throw.fetch_sub(1) == 1) {
+      throw std::runtime_error("copy");
+    }
+    ++instances;
+  }
+
+  ~counted_element() {
+    --instances;
+  }
+
+  int value;
+
+  static inline std::atomic<size_t> instances = 0;
+  static inline std::atomic<size_t> copies_until_throw = 0;
+};
+
+struct relocatable_element {
+  relocatable_element(int data)
+      : data(data) {}
+
+  relocatable_element(const relocatable_element& other)
+      : data(other.data) {
+    ++copy_counter;
+  }
+
+  relocatable_element(relocatable_element&& other)
+      : data(other.data) {
+    ++move_counter;
+  }
+
+  operator int() const {
+    return data;
+  }
+
+  int data;
+
+  inline static size_t copy_counter = 0;
+  inline static size_t move_counter = 0;
+};
+
+template <typename C>
+bool is_stored_inline(const C& c) {
+  const void* begin = &c;
+  const void* end = &c + 1;
+  std::less<const void*> less;
+  return !less(c.data(), begin) && less(c.data(), end);
+}
+
 class correctness_test : public base_test {};
 
 class exception_safety_test : public base_test {};
@@ -122,6 +233,9 @@ class performance_test : public base_test {};
 
 } // namespace
 
+template <>
+struct is_trivially_relocatable<relocatable_element> : std::true_type {};
+
 TEST_F(correctness_test, default_ctor) {
   vector<element> a;
   expect_empty_storage(a);
@@ -229,6 +343,117 @@ TEST_F(correctness_test, push_back_reallocation_noexcept) {
   ASSERT_LE(element::get_copy_counter(), 501);
 }
 
+TEST_F(correctness_test, unchecked_push_back) {
+  static constexpr size_t N = 500;
+
+  vector<element> a;
+  a.reserve(N);
+  element* data = a.data();
+  for (size_t i = 0; i + 1 < N; ++i) {
+    a.unchecked_push_back(2 * i + 1);
+  }
+  element x = 42;
+  a.unchecked_emplace_back(x);
+  EXPECT_EQ(N, a.size());
+  EXPECT_EQ(N, a.capacity());
+  EXPECT_EQ(data, a.data());
+  EXPECT_EQ(42, a.back());
+  for (size_t i = 0; i + 1 < N; ++i) {
+    ASSERT_EQ(2 * i + 1, a[i]);
+  }
+}
+
+TEST_F(exception_safety_test, unchecked_push_back_throw) {
+  faulty_run([] {
+    fault_injection_disable dg;
+    vector<element> a;
+    a.reserve(10);
+    for (int i = 0; i < 5; ++i) {
+      a.push_back(i);
+    }
+    dg.reset();
+
+    strong_exception_safety_guard sg(a);
+    a.unchecked_push_back(5);
+  });
+}
+
+TEST_F(correctness_test, push_back_xvalue) {
+  static constexpr size_t N = 500;
+
+  vector<element> a;
+  a.reserve(N);
+  for (size_t i = 0; i < N; ++i) {
+    element x = 2 * i + 1;
+    element::reset_counters();
+    a.push_back(std::move(x));
+    ASSERT_EQ(0, element::get_copy_counter());
+    ASSERT_EQ(1, element::get_move_counter());
+  }
+
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(2 * i + 1, a[i]);
+  }
+}
+
+TEST_F(exception_safety_test, push_back_xvalue_throw) {
+  static constexpr size_t N = 10;
+
+  faulty_run([] {
+    vector<element> a;
+    for (size_t i = 0; i < N; ++i) {
+      element x = 2 * i + 1;
+      strong_exception_safety_guard sg(a);
+      a.push_back(std::move(x));
+    }
+  });
+}
+
+TEST_F(correctness_test, emplace_back) {
+  static constexpr size_t N = 500;
+
+  vector<element> a;
+  a.reserve(N);
+  for (size_t i = 0; i < N; ++i) {
+    element::reset_counters();
+    element& x = a.emplace_back(2 * i + 1);
+    ASSERT_EQ(0, element::get_copy_counter());
+    ASSERT_EQ(0, element::get_move_counter());
+    ASSERT_EQ(&a.back(), &x);
+  }
+
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(2 * i + 1, a[i]);
+  }
+}
+
+TEST_F(correctness_test, emplace_back_from_self) {
+  static constexpr size_t N = 500;
+
+  vector<element> a;
+  a.emplace_back(42);
+  for (size_t i = 1; i < N; ++i) {
+    a.emplace_back(a[0]);
+  }
+
+  EXPECT_EQ(N, a.size());
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(42, a[i]);
+  }
+}
+
+TEST_F(exception_safety_test, emplace_back_throw) {
+  static constexpr size_t N = 10;
+
+  faulty_run([] {
+    vector<element> a;
+    for (size_t i = 0; i < N; ++i) {
+      strong_exception_safety_guard sg(a);
+      a.emplace_back(2 * i + 1);
+    }
+  });
+}
+
 TEST_F(correctness_test, subscripting) {
   static constexpr size_t N = 500;
 
@@ -402,6 +627,52 @@ TEST_F(correctness_test, reserve_noexcept) {
   }
 }
 
+TEST_F(correctness_test, reserve_trivially_relocatable) {
+  static constexpr size_t N = 500, M = 100, K = 5000;
+
+  vector<relocatable_element> a;
+  a.reserve(N);
+  for (size_t i = 0; i < M; ++i) {
+    a.push_back(2 * i + 1);
+  }
+
+  relocatable_element::copy_counter = 0;
+  relocatable_element::move_counter = 0;
+  a.reserve(K);
+  a.shrink_to_fit();
+  EXPECT_EQ(0, relocatable_element::copy_counter);
+  EXPECT_EQ(0, relocatable_element::move_counter);
+
+  EXPECT_EQ(M, a.size());
+  EXPECT_EQ(M, a.capacity());
+  for (size_t i = 0; i < M; ++i) {
+    ASSERT_EQ(2 * i + 1, a[i]);
+  }
+}
+
+TEST_F(correctness_test, reserve_move_only) {
+  static constexpr size_t N = 500;
+
+  vector<std::unique_ptr<size_t>> a;
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(std::make_unique<size_t>(2 * i + 1));
+  }
+  a.reserve(N * 2);
+  a.shrink_to_fit();
+
+  EXPECT_EQ(N, a.capacity());
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(2 * i + 1, *a[i]);
+  }
+}
+
+TEST_F(correctness_test, nested_vector_is_trivially_relocatable) {
+  EXPECT_TRUE(is_trivially_relocatable_v<int>);
+  EXPECT_TRUE(is_trivially_relocatable_v<vector<int>>);
+  EXPECT_TRUE(is_trivially_relocatable_v<vector<element>>);
+  EXPECT_FALSE(is_trivially_relocatable_v<element>);
+}
+
 TEST_F(correctness_test, shrink_to_fit) {
   static constexpr size_t N = 500, M = 100;
 
@@ -475,6 +746,76 @@ TEST_F(exception_safety_test, shrink_to_fit_throw) {
   });
 }
 
+TEST_F(correctness_test, shrink_to) {
+  vector<element> a;
+  a.reserve(100);
+  for (int i = 0; i < 10; ++i) {
+    a.push_back(i);
+  }
+  a.shrink_to(50);
+  EXPECT_EQ(50, a.capacity());
+  a.shrink_to(60);
+  EXPECT_EQ(50, a.capacity());
+  a.shrink_to(0);
+  EXPECT_EQ(10, a.capacity());
+  expect_eq(a, std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+  a.clear();
+  a.shrink_to(0);
+  expect_empty_storage(a);
+}
+
+TEST_F(exception_safety_test, shrink_to_throw) {
+  faulty_run([] {
+    fault_injection_disable dg;
+    vector<element> a;
+    a.reserve(20);
+    for (int i = 0; i < 10; ++i) {
+      a.push_back(i);
+    }
+    dg.reset();
+
+    strong_exception_safety_guard sg(a);
+    a.shrink_to(15);
+  });
+}
+
+TEST_F(correctness_test, memory_usage) {
+  vector<element> a;
+  EXPECT_EQ(vector_memory_usage{}, a.memory_usage());
+  a.reserve(10);
+  for (int i = 0; i < 4; ++i) {
+    a.push_back(i);
+  }
+  EXPECT_EQ((vector_memory_usage{4 * sizeof(element), 10 * sizeof(element)}), a.memory_usage());
+  EXPECT_EQ(6 * sizeof(element), a.memory_usage().slack());
+  EXPECT_EQ(a.memory_usage(), a.deep_memory_usage());
+  a.shrink_to_fit();
+  EXPECT_EQ(0, a.memory_usage().slack());
+
+  small_vector<int, 4> b;
+  b.push_back(1);
+  EXPECT_EQ(vector_memory_usage{}, b.memory_usage());
+}
+
+TEST_F(correctness_test, deep_memory_usage) {
+  vector<vector<int>> a;
+  a.reserve(4);
+  for (size_t i = 0; i < 3; ++i) {
+    a.emplace_back();
+    a.back().reserve(8);
+    for (size_t j = 0; j < i; ++j) {
+      a.back().push_back(j);
+    }
+  }
+  vector_memory_usage outer = {3 * sizeof(vector<int>), 4 * sizeof(vector<int>)};
+  EXPECT_EQ(outer, a.memory_usage());
+  vector_memory_usage deep = outer;
+  deep += {3 * sizeof(int), 24 * sizeof(int)};
+  EXPECT_EQ(deep, a.deep_memory_usage());
+  EXPECT_EQ(sizeof(vector<int>) + 21 * sizeof(int), a.deep_memory_usage().slack());
+}
+
 TEST_F(correctness_test, shrink_to_fit_noexcept) {
   static constexpr size_t N = 500, M = 100;
 
@@ -879,87 +1220,440 @@ TEST_F(correctness_test, insert_xvalue_reallocation_noexcept) {
   ASSERT_LE(element::get_copy_counter(), 501);
 }
 
-TEST_F(correctness_test, erase) {
-  static constexpr size_t N = 500;
+TEST_F(correctness_test, insert_xvalue) {
+  static constexpr size_t N = 500, K = 7;
 
+  vector<element> a;
+  a.reserve(N + 1);
   for (size_t i = 0; i < N; ++i) {
-    vector<element> a;
-    for (size_t j = 0; j < N; ++j) {
-      a.push_back(2 * j + 1);
-    }
-
-    size_t old_capacity = a.capacity();
-    element* old_data = a.data();
+    a.push_back(2 * i + 1);
+  }
 
-    auto it = a.erase(std::as_const(a).begin() + i);
-    ASSERT_EQ(a.begin() + i, it);
-    ASSERT_EQ(N - 1, a.size());
-    ASSERT_EQ(old_capacity, a.capacity());
-    ASSERT_EQ(old_data, a.data());
+  element x = 42;
+  element::reset_counters();
+  auto it = a.insert(a.begin() + K, std::move(x));
+  ASSERT_EQ(0, element::get_copy_counter());
+  ASSERT_EQ(a.begin() + K, it);
+  ASSERT_EQ(N + 1, a.size());
 
-    for (size_t j = 0; j < i; ++j) {
-      ASSERT_EQ(2 * j + 1, a[j]);
-    }
-    for (size_t j = i; j < N - 1; ++j) {
-      ASSERT_EQ(2 * (j + 1) + 1, a[j]);
-    }
+  for (size_t i = 0; i < K; ++i) {
+    ASSERT_EQ(2 * i + 1, a[i]);
+  }
+  ASSERT_EQ(42, a[K]);
+  for (size_t i = K; i < N; ++i) {
+    ASSERT_EQ(2 * i + 1, a[i + 1]);
   }
 }
 
-TEST_F(correctness_test, erase_begin) {
+TEST_F(correctness_test, emplace) {
   static constexpr size_t N = 500;
 
   vector<element> a;
-  for (size_t i = 0; i < N * 2; ++i) {
-    a.push_back(2 * i + 1);
-  }
-
   for (size_t i = 0; i < N; ++i) {
-    auto it = a.erase(a.begin());
-    ASSERT_EQ(a.begin(), it);
+    auto it = a.emplace(a.begin() + i / 2, i);
+    ASSERT_EQ(a.begin() + i / 2, it);
+    ASSERT_EQ(i, *it);
   }
 
+  vector<element> b;
   for (size_t i = 0; i < N; ++i) {
-    ASSERT_EQ(2 * (i + N) + 1, a[i]);
+    b.insert(b.begin() + i / 2, element(i));
   }
+  expect_eq(a, b);
 }
 
-TEST_F(correctness_test, erase_end) {
+TEST_F(correctness_test, resize) {
+  vector<int> a;
+  a.resize(5);
+  expect_eq(a, std::vector<int>{0, 0, 0, 0, 0});
+
+  a.resize(7, 3);
+  expect_eq(a, std::vector<int>{0, 0, 0, 0, 0, 3, 3});
+
+  size_t old_capacity = a.capacity();
+  a.resize(2);
+  expect_eq(a, std::vector<int>{0, 0});
+  EXPECT_EQ(old_capacity, a.capacity());
+}
+
+TEST_F(correctness_test, resize_from_self) {
   static constexpr size_t N = 500;
 
   vector<element> a;
-  for (size_t i = 0; i < N * 2; ++i) {
-    a.push_back(2 * i + 1);
+  a.push_back(42);
+  for (size_t i = 1; i < N; i *= 2) {
+    a.shrink_to_fit();
+    a.resize(2 * i, a.back());
   }
-
-  for (size_t i = 0; i < N; ++i) {
-    auto it = a.erase(a.end() - 1);
-    ASSERT_EQ(a.end(), it);
+  for (size_t i = 0; i < a.size(); ++i) {
+    ASSERT_EQ(42, a[i]);
   }
+}
 
-  for (size_t i = 0; i < N; ++i) {
-    ASSERT_EQ(2 * i + 1, a[i]);
+TEST_F(exception_safety_test, resize_throw) {
+  static constexpr size_t N = 10;
+
+  for (size_t capacity : {N, 2 * N}) {
+    faulty_run([capacity] {
+      fault_injection_disable dg;
+      vector<element> a;
+      a.reserve(capacity);
+      for (size_t i = 0; i < N; ++i) {
+        a.push_back(2 * i + 1);
+      }
+      element value(42);
+      dg.reset();
+
+      strong_exception_safety_guard sg(a);
+      a.resize(2 * N, value);
+    });
   }
 }
 
-TEST_F(correctness_test, erase_range_begin) {
-  static constexpr size_t N = 500, K = 100;
+TEST_F(correctness_test, resize_for_overwrite) {
+  static constexpr size_t N = 1'000;
 
-  vector<element> a;
+  vector<int> a;
+  a.resize_for_overwrite(N);
+  ASSERT_EQ(N, a.size());
   for (size_t i = 0; i < N; ++i) {
-    a.push_back(2 * i + 1);
+    a[i] = i;
+  }
+  a.resize_for_overwrite(N / 2);
+  a.resize_for_overwrite(2 * N);
+  ASSERT_EQ(2 * N, a.size());
+  for (size_t i = 0; i < N / 2; ++i) {
+    ASSERT_EQ(i, a[i]);
   }
 
-  size_t old_capacity = a.capacity();
-  element* old_data = a.data();
+  vector<std::string> b;
+  b.resize_for_overwrite(3);
+  ASSERT_EQ(3, b.size());
+  EXPECT_TRUE(b[2].empty());
+}
 
-  auto it = a.erase(std::as_const(a).begin(), std::as_const(a).begin() + K);
-  EXPECT_EQ(a.begin(), it);
-  EXPECT_EQ(N - K, a.size());
-  EXPECT_EQ(old_capacity, a.capacity());
-  EXPECT_EQ(old_data, a.data());
+TEST_F(performance_test, resize_for_overwrite) {
+  static constexpr size_t N = 64 << 20, K = 50;
 
-  for (size_t i = 0; i < N - K; ++i) {
+  for (size_t i = 0; i < K; ++i) {
+    vector<char> a;
+    a.resize_for_overwrite(N);
+    ASSERT_EQ(N, a.size());
+    a[N - 1] = 'x';
+  }
+}
+
+TEST_F(correctness_test, insert_range) {
+  static constexpr size_t N = 500, M = 100, K = 7;
+
+  for (size_t pos : {size_t(0), K, N}) {
+    vector<element> a;
+    std::vector<int> expected;
+    for (size_t i = 0; i < N; ++i) {
+      a.push_back(2 * i + 1);
+      expected.push_back(2 * i + 1);
+    }
+    std::vector<int> values;
+    for (size_t i = 0; i < M; ++i) {
+      values.push_back(4 * i);
+    }
+
+    auto it = a.insert(a.begin() + pos, values.begin(), values.end());
+    expected.insert(expected.begin() + pos, values.begin(), values.end());
+    ASSERT_EQ(a.begin() + pos, it);
+    expect_eq(a, expected);
+  }
+}
+
+TEST_F(correctness_test, insert_range_no_reallocation) {
+  static constexpr size_t N = 500, M = 100, K = 7;
+
+  vector<element> a;
+  a.reserve(N + M);
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(2 * i + 1);
+  }
+  element* old_data = a.data();
+
+  std::vector<element> values;
+  for (size_t i = 0; i < M; ++i) {
+    values.push_back(4 * i);
+  }
+
+  element::reset_counters();
+  a.insert(a.begin() + K, values.begin(), values.end());
+  EXPECT_EQ(M, element::get_copy_counter());
+  EXPECT_EQ(old_data, a.data());
+  EXPECT_EQ(N + M, a.capacity());
+
+  for (size_t i = 0; i < K; ++i) {
+    ASSERT_EQ(2 * i + 1, a[i]);
+  }
+  for (size_t i = 0; i < M; ++i) {
+    ASSERT_EQ(4 * i, a[K + i]);
+  }
+  for (size_t i = K; i < N; ++i) {
+    ASSERT_EQ(2 * i + 1, a[M + i]);
+  }
+}
+
+TEST_F(correctness_test, insert_range_reallocation_noexcept) {
+  static constexpr size_t N = 500, M = 100, K = 7;
+
+  vector<element_with_non_throwing_move> a;
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(2 * i + 1);
+  }
+
+  std::vector<int> values(M, 42);
+  element::reset_counters();
+  a.insert(a.begin() + K, values.begin(), values.end());
+  EXPECT_EQ(0, element::get_copy_counter());
+  EXPECT_EQ(N, element::get_move_counter());
+  EXPECT_EQ(N + M, a.size());
+}
+
+TEST_F(correctness_test, insert_range_input_iterator) {
+  std::istringstream in("1 2 3 4 5");
+  vector<element> a;
+  a.push_back(0);
+  a.push_back(6);
+
+  a.insert(a.begin() + 1, std::istream_iterator<int>(in), std::istream_iterator<int>());
+  expect_eq(a, std::vector<int>{0, 1, 2, 3, 4, 5, 6});
+}
+
+TEST_F(exception_safety_test, insert_range_throw) {
+  static constexpr size_t N = 10, M = 5;
+
+  faulty_run([] {
+    fault_injection_disable dg;
+    vector<element> a;
+    a.reserve(N);
+    for (size_t i = 0; i < N; ++i) {
+      a.push_back(2 * i + 1);
+    }
+    std::vector<element> values;
+    for (size_t i = 0; i < M; ++i) {
+      values.push_back(4 * i);
+    }
+    dg.reset();
+
+    strong_exception_safety_guard sg(a);
+    a.insert(a.begin() + 3, values.begin(), values.end());
+  });
+}
+
+TEST_F(correctness_test, insert_count) {
+  static constexpr size_t N = 500, M = 100, K = 7;
+
+  vector<element> a;
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(2 * i + 1);
+  }
+
+  auto it = a.insert(a.begin() + K, M, element(42));
+  ASSERT_EQ(a.begin() + K, it);
+  ASSERT_EQ(N + M, a.size());
+  for (size_t i = 0; i < M; ++i) {
+    ASSERT_EQ(42, a[K + i]);
+  }
+
+  a.insert(a.begin(), 3, a.back());
+  a.insert(a.end(), 3, a[0]);
+  ASSERT_EQ(N + M + 6, a.size());
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(2 * N - 1, a[i]);
+    ASSERT_EQ(2 * N - 1, a[N + M + 3 + i]);
+  }
+}
+
+TEST_F(correctness_test, insert_count_from_self_trivial) {
+  vector<int> a;
+  a.reserve(10);
+  a.push_back(1);
+  a.push_back(2);
+
+  a.insert(a.begin(), 3, a[1]);
+  expect_eq(a, std::vector<int>{2, 2, 2, 1, 2});
+  a.emplace(a.begin(), a[3]);
+  expect_eq(a, std::vector<int>{1, 2, 2, 2, 1, 2});
+}
+
+TEST_F(exception_safety_test, insert_count_throw) {
+  static constexpr size_t N = 10, M = 5;
+
+  faulty_run([] {
+    fault_injection_disable dg;
+    vector<element> a;
+    a.reserve(N);
+    for (size_t i = 0; i < N; ++i) {
+      a.push_back(2 * i + 1);
+    }
+    dg.reset();
+
+    strong_exception_safety_guard sg(a);
+    a.insert(a.begin() + 3, M, a[0]);
+  });
+}
+
+TEST_F(correctness_test, insert_initializer_list) {
+  vector<element> a;
+  a.insert(a.end(), {1, 5});
+  a.insert(a.begin() + 1, {2, 3, 4});
+  expect_eq(a, std::vector<int>{1, 2, 3, 4, 5});
+}
+
+TEST_F(correctness_test, append_range) {
+  static constexpr size_t N = 500;
+
+  vector<element> a;
+  std::list<int> values;
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(i);
+    values.push_back(N + i);
+  }
+
+  a.append_range(values);
+  ASSERT_EQ(2 * N, a.size());
+  for (size_t i = 0; i < 2 * N; ++i) {
+    ASSERT_EQ(i, a[i]);
+  }
+
+  a.insert_range(a.begin(), std::views::iota(0, 3));
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(i, a[i]);
+  }
+  ASSERT_EQ(0, a[3]);
+}
+
+TEST_F(correctness_test, assign) {
+  vector<element> a;
+  a.assign(5, element(1));
+  expect_eq(a, std::vector<int>{1, 1, 1, 1, 1});
+
+  size_t old_capacity = a.capacity();
+  element* old_data = a.data();
+  a.assign({2, 3, 4});
+  expect_eq(a, std::vector<int>{2, 3, 4});
+  EXPECT_EQ(old_capacity, a.capacity());
+  EXPECT_EQ(old_data, a.data());
+
+  std::vector<int> values(100, 7);
+  a.assign(values.begin(), values.end());
+  expect_eq(a, values);
+
+  a.assign(3, element(5));
+  expect_eq(a, std::vector<int>{5, 5, 5});
+
+  std::istringstream in("8 9");
+  a.assign(std::istream_iterator<int>(in), std::istream_iterator<int>());
+  expect_eq(a, std::vector<int>{8, 9});
+
+  a.assign_range(std::views::iota(0, 4));
+  expect_eq(a, std::vector<int>{0, 1, 2, 3});
+}
+
+TEST_F(performance_test, insert_range) {
+  static constexpr size_t N = 1'000'000, M = 50'000, K = 20;
+
+  vector<int> a;
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(i);
+  }
+  std::vector<int> block(M, -1);
+
+  for (size_t i = 0; i < K; ++i) {
+    a.insert(a.begin() + i, block.begin(), block.end());
+  }
+
+  ASSERT_EQ(N + M * K, a.size());
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(i, a[M * K + i]);
+  }
+}
+
+TEST_F(correctness_test, erase) {
+  static constexpr size_t N = 500;
+
+  for (size_t i = 0; i < N; ++i) {
+    vector<element> a;
+    for (size_t j = 0; j < N; ++j) {
+      a.push_back(2 * j + 1);
+    }
+
+    size_t old_capacity = a.capacity();
+    element* old_data = a.data();
+
+    auto it = a.erase(std::as_const(a).begin() + i);
+    ASSERT_EQ(a.begin() + i, it);
+    ASSERT_EQ(N - 1, a.size());
+    ASSERT_EQ(old_capacity, a.capacity());
+    ASSERT_EQ(old_data, a.data());
+
+    for (size_t j = 0; j < i; ++j) {
+      ASSERT_EQ(2 * j + 1, a[j]);
+    }
+    for (size_t j = i; j < N - 1; ++j) {
+      ASSERT_EQ(2 * (j + 1) + 1, a[j]);
+    }
+  }
+}
+
+TEST_F(correctness_test, erase_begin) {
+  static constexpr size_t N = 500;
+
+  vector<element> a;
+  for (size_t i = 0; i < N * 2; ++i) {
+    a.push_back(2 * i + 1);
+  }
+
+  for (size_t i = 0; i < N; ++i) {
+    auto it = a.erase(a.begin());
+    ASSERT_EQ(a.begin(), it);
+  }
+
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(2 * (i + N) + 1, a[i]);
+  }
+}
+
+TEST_F(correctness_test, erase_end) {
+  static constexpr size_t N = 500;
+
+  vector<element> a;
+  for (size_t i = 0; i < N * 2; ++i) {
+    a.push_back(2 * i + 1);
+  }
+
+  for (size_t i = 0; i < N; ++i) {
+    auto it = a.erase(a.end() - 1);
+    ASSERT_EQ(a.end(), it);
+  }
+
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(2 * i + 1, a[i]);
+  }
+}
+
+TEST_F(correctness_test, erase_range_begin) {
+  static constexpr size_t N = 500, K = 100;
+
+  vector<element> a;
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(2 * i + 1);
+  }
+
+  size_t old_capacity = a.capacity();
+  element* old_data = a.data();
+
+  auto it = a.erase(std::as_const(a).begin(), std::as_const(a).begin() + K);
+  EXPECT_EQ(a.begin(), it);
+  EXPECT_EQ(N - K, a.size());
+  EXPECT_EQ(old_capacity, a.capacity());
+  EXPECT_EQ(old_data, a.data());
+
+  for (size_t i = 0; i < N - K; ++i) {
     ASSERT_EQ(2 * (i + K) + 1, a[i]);
   }
 }
@@ -1050,6 +1744,100 @@ TEST_F(performance_test, erase) {
   }
 }
 
+TEST_F(correctness_test, swap_remove) {
+  vector<element> a;
+  for (int i = 0; i < 5; ++i) {
+    a.push_back(i);
+  }
+
+  auto it = a.swap_remove(a.begin() + 1);
+  EXPECT_EQ(a.begin() + 1, it);
+  expect_eq(a, std::vector<int>{0, 4, 2, 3});
+
+  it = a.swap_remove(a.end() - 1);
+  EXPECT_EQ(a.end(), it);
+  expect_eq(a, std::vector<int>{0, 4, 2});
+
+  vector<int> b;
+  b.push_back(1);
+  b.push_back(2);
+  b.swap_remove(b.begin());
+  expect_eq(b, std::vector<int>{2});
+}
+
+TEST_F(correctness_test, erase_if) {
+  static constexpr size_t N = 500;
+
+  vector<element> a;
+  vector<int> b;
+  std::vector<int> expected;
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(i);
+    b.push_back(i);
+    if (i % 3 != 0) {
+      expected.push_back(i);
+    }
+  }
+
+  EXPECT_EQ(N - expected.size(), erase_if(a, [](const element& x) { return x % 3 == 0; }));
+  expect_eq(a, expected);
+  EXPECT_EQ(N - expected.size(), erase_if(b, [](int x) { return x % 3 == 0; }));
+  expect_eq(b, expected);
+
+  EXPECT_EQ(1, erase(a, 4));
+  EXPECT_EQ(0, erase(a, 3));
+  EXPECT_EQ(expected.size() - 1, a.size());
+  size_t size = a.size();
+  EXPECT_EQ(size, erase_if(a, [](const element&) { return true; }));
+  EXPECT_TRUE(a.empty());
+}
+
+TEST_F(exception_safety_test, erase_if_throw) {
+  static constexpr size_t N = 10;
+
+  vector<element> a;
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(i);
+  }
+
+  size_t calls = 0;
+  EXPECT_THROW(erase_if(a,
+                        [&](const element& x) {
+                          if (++calls == N / 2) {
+                            throw std::runtime_error("pred");
+                          }
+                          return x % 2 == 0;
+                        }),
+               std::runtime_error);
+  EXPECT_EQ(N, a.size());
+}
+
+TEST_F(performance_test, swap_remove) {
+  static constexpr size_t N = 500'000;
+
+  vector<element> a;
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(i);
+  }
+  while (a.size() > 1) {
+    a.swap_remove(a.begin() + a.size() / 2);
+  }
+  EXPECT_EQ(0, a[0]);
+}
+
+TEST_F(performance_test, erase_if) {
+  static constexpr size_t N = 1'000'000;
+
+  vector<element> a;
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(i);
+  }
+  EXPECT_EQ(N / 2, erase_if(a, [](const element& x) { return x % 2 == 0; }));
+  for (size_t i = 0; i < N / 2; ++i) {
+    ASSERT_EQ(2 * i + 1, a[i]);
+  }
+}
+
 TEST_F(exception_safety_test, reallocation_throw) {
   static constexpr size_t N = 10;
 
@@ -1149,12 +1937,902 @@ TEST_F(exception_safety_test, move_assign_throw) {
   });
 }
 
-TEST_F(correctness_test, member_aliases) {
+TEST_F(correctness_test, allocator_copy) {
+  static constexpr size_t N = 500;
+
+  using allocator = tagged_allocator<element, false>;
+  vector<element, allocator> a(allocator(1));
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(2 * i + 1);
+  }
+
+  vector<element, allocator> b(a);
+  EXPECT_EQ(1, b.get_allocator().tag);
+  expect_eq(a, b);
+
+  vector<element, allocator> c(a, allocator(2));
+  EXPECT_EQ(2, c.get_allocator().tag);
+  expect_eq(a, c);
+
+  vector<element, allocator> d(allocator(3));
+  d = a;
+  EXPECT_EQ(3, d.get_allocator().tag);
+  expect_eq(a, d);
+}
+
+TEST_F(correctness_test, allocator_copy_assignment_propagate) {
+  static constexpr size_t N = 500;
+
+  using allocator = tagged_allocator<element, true>;
+  vector<element, allocator> a(allocator(1));
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(2 * i + 1);
+  }
+
+  vector<element, allocator> b(allocator(2));
+  b.push_back(42);
+  b = a;
+  EXPECT_EQ(1, b.get_allocator().tag);
+  expect_eq(a, b);
+}
+
+TEST_F(correctness_test, allocator_move_assignment_unequal) {
+  static constexpr size_t N = 500;
+
+  using allocator = tagged_allocator<element_with_non_throwing_move, false>;
+  vector<element_with_non_throwing_move, allocator> a(allocator(1));
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(2 * i + 1);
+  }
+  element_with_non_throwing_move* a_data = a.data();
+
+  vector<element_with_non_throwing_move, allocator> b(allocator(2));
+  b.push_back(42);
+
+  element::reset_counters();
+  b = std::move(a);
+  EXPECT_EQ(0, element::get_copy_counter());
+  EXPECT_EQ(N, element::get_move_counter());
+  EXPECT_EQ(2, b.get_allocator().tag);
+  EXPECT_NE(a_data, b.data());
+
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(2 * i + 1, b[i]);
+  }
+}
+
+TEST_F(correctness_test, allocator_move_assignment_propagate) {
+  static constexpr size_t N = 500;
+
+  using allocator = tagged_allocator<element, true>;
+  vector<element, allocator> a(allocator(1));
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(2 * i + 1);
+  }
+  element* a_data = a.data();
+
+  vector<element, allocator> b(allocator(2));
+  b.push_back(42);
+
+  element::reset_counters();
+  b = std::move(a);
+  EXPECT_EQ(0, element::get_copy_counter());
+  EXPECT_EQ(0, element::get_move_counter());
+  EXPECT_EQ(1, b.get_allocator().tag);
+  EXPECT_EQ(a_data, b.data());
+}
+
+TEST_F(correctness_test, allocator_swap_propagate) {
+  using allocator = tagged_allocator<element, true>;
+  vector<element, allocator> a(allocator(1));
+  a.push_back(1);
+  vector<element, allocator> b(allocator(2));
+  b.push_back(2);
+
+  a.swap(b);
+  EXPECT_EQ(2, a.get_allocator().tag);
+  EXPECT_EQ(1, b.get_allocator().tag);
+  EXPECT_EQ(2, a[0]);
+  EXPECT_EQ(1, b[0]);
+}
+
+TEST_F(correctness_test, polymorphic_allocator) {
+  static constexpr size_t N = 100;
+
+  std::pmr::monotonic_buffer_resource resource;
+  vector<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>> a(&resource);
+  for (size_t i = 0; i < N; ++i) {
+    a.emplace_back(std::to_string(i) + " is a string too long for the small string optimization");
+  }
+
+  EXPECT_EQ(&resource, a.get_allocator().resource());
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(&resource, a[i].get_allocator().resource());
+    ASSERT_EQ(std::to_string(i) + " is a string too long for the small string optimization", std::string_view(a[i]));
+  }
+
+  auto b = a;
+  EXPECT_EQ(std::pmr::get_default_resource(), b.get_allocator().resource());
+  expect_eq(a, b);
+}
+
+TEST_F(correctness_test, member_aliases) {
   EXPECT_TRUE((std::is_same<element, vector<element>::value_type>::value));
+  EXPECT_TRUE((std::is_same<std::allocator<element>, vector<element>::allocator_type>::value));
   EXPECT_TRUE((std::is_same<element&, vector<element>::reference>::value));
   EXPECT_TRUE((std::is_same<const element&, vector<element>::const_reference>::value));
   EXPECT_TRUE((std::is_same<element*, vector<element>::pointer>::value));
   EXPECT_TRUE((std::is_same<const element*, vector<element>::const_pointer>::value));
-  EXPECT_TRUE((std::is_same<element*, vector<element>::iterator>::value));
-  EXPECT_TRUE((std::is_same<const element*, vector<element>::const_iterator>::value));
+  if constexpr (detail::checks_enabled) {
+    EXPECT_TRUE((std::is_same<detail::checked_iterator<element, vector<element>>, vector<element>::iterator>::value));
+    EXPECT_TRUE((std::is_same<detail::checked_iterator<const element, vector<element>>,
+                              vector<element>::const_iterator>::value));
+  } else {
+    EXPECT_TRUE((std::is_same<element*, vector<element>::iterator>::value));
+    EXPECT_TRUE((std::is_same<const element*, vector<element>::const_iterator>::value));
+  }
+}
+
+TEST_F(correctness_test, growth_policy_default) {
+  vector<int> a;
+  std::vector<size_t> capacities;
+  for (size_t i = 0; i < 100; ++i) {
+    if (a.size() == a.capacity()) {
+      a.push_back(i);
+      capacities.push_back(a.capacity());
+    } else {
+      a.push_back(i);
+    }
+  }
+  EXPECT_EQ((std::vector<size_t>{1, 2, 4, 8, 16, 32, 64, 128}), capacities);
+}
+
+TEST_F(correctness_test, growth_policy_factor) {
+  vector<element, std::allocator<element>, 0, one_and_a_half_growth> a;
+  std::vector<size_t> capacities;
+  for (size_t i = 0; i < 20; ++i) {
+    bool full = a.size() == a.capacity();
+    a.push_back(i);
+    if (full) {
+      capacities.push_back(a.capacity());
+    }
+  }
+  EXPECT_EQ((std::vector<size_t>{1, 2, 3, 4, 6, 9, 13, 19, 28}), capacities);
+  for (size_t i = 0; i < 20; ++i) {
+    ASSERT_EQ(i, a[i]);
+  }
+
+  a.insert(a.begin(), 20, element(0));
+  EXPECT_EQ(42, a.capacity());
+
+  a.reserve(100);
+  EXPECT_EQ(100, a.capacity());
+}
+
+TEST_F(correctness_test, growth_policy_page_rounding) {
+  static constexpr size_t N = 10'000;
+
+  vector<int, std::allocator<int>, 0, page_rounding_growth<>> a;
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(i);
+    size_t bytes = a.capacity() * sizeof(int);
+    if (bytes >= 4096) {
+      ASSERT_EQ(0, bytes % 4096);
+    }
+  }
+
+  a.shrink_to_fit();
+  a.push_back(0);
+  EXPECT_EQ(81920 / sizeof(int), a.capacity());
+
+  vector<int, std::allocator<int>, 0, page_rounding_growth<>> b;
+  b.resize_for_overwrite((2 << 20) / sizeof(int) + 1);
+  EXPECT_EQ((4 << 20) / sizeof(int), b.capacity());
+}
+
+TEST_F(correctness_test, growth_policy_size_class) {
+  static constexpr size_t N = 1'000;
+
+  vector<int, std::allocator<int>, 0, size_class_growth<>> a;
+  for (size_t i = 0; i < N; ++i) {
+    bool full = a.size() == a.capacity();
+    size_t old_capacity = a.capacity();
+    a.push_back(i);
+    if (full) {
+      ASSERT_GE(a.capacity(), std::max<size_t>(2 * old_capacity, 1));
+    }
+  }
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(i, a[i]);
+  }
+}
+
+TEST_F(correctness_test, aligned_vector) {
+  static constexpr size_t N = 1'000;
+
+  auto is_aligned = [](const void* ptr, size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+  };
+
+  aligned_vector<float, 32> a;
+  aligned_vector<element> b;
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(i);
+    b.push_back(i);
+    ASSERT_TRUE(is_aligned(a.data(), 32));
+    ASSERT_TRUE(is_aligned(b.data(), 64));
+  }
+
+  a.resize(N - 3);
+  a.shrink_to_fit();
+  EXPECT_TRUE(is_aligned(a.data(), 32));
+
+  aligned_vector<float, 32> c = a;
+  EXPECT_TRUE(is_aligned(c.data(), 32));
+  expect_eq(a, c);
+  EXPECT_TRUE(is_trivially_relocatable_v<aligned_vector<float>>);
+}
+
+TEST_F(correctness_test, over_aligned_element) {
+  struct alignas(64) over_aligned {
+    int value;
+  };
+
+  vector<over_aligned> a;
+  small_vector<over_aligned, 2> b;
+  for (int i = 0; i < 10; ++i) {
+    a.push_back({i});
+    b.push_back({i});
+    ASSERT_EQ(0, reinterpret_cast<std::uintptr_t>(a.data()) % 64);
+    ASSERT_EQ(0, reinterpret_cast<std::uintptr_t>(b.data()) % 64);
+  }
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(i, a[i].value);
+    ASSERT_EQ(i, b[i].value);
+  }
+}
+
+TEST_F(correctness_test, stats) {
+  vector<element>::reset_stats();
+  vector<int>::reset_stats();
+
+  vector<element> a;
+  vector<int> b;
+  for (int i = 0; i < 5; ++i) {
+    a.push_back(element(i));
+    b.push_back(i);
+  }
+  vector<element> c = a;
+
+  if constexpr (!detail::stats_enabled) {
+    EXPECT_EQ(vector_stats{}, vector<element>::stats());
+    EXPECT_EQ(vector_stats{}, vector<int>::stats());
+    return;
+  }
+
+  vector_stats element_stats = vector<element>::stats();
+  EXPECT_EQ(5, element_stats.allocations);
+  EXPECT_EQ((1 + 2 + 4 + 8 + 5) * sizeof(element), element_stats.allocated_bytes);
+  EXPECT_EQ(3, element_stats.reallocations);
+  // Relocation copies because the move constructor of `element` may throw
+  EXPECT_EQ(1 + 2 + 4 + 5, element_stats.copies);
+  EXPECT_EQ(5, element_stats.moves);
+
+  vector_stats int_stats = vector<int>::stats();
+  EXPECT_EQ(4, int_stats.allocations);
+  EXPECT_EQ(3, int_stats.reallocations);
+  EXPECT_EQ(5, int_stats.copies);
+  EXPECT_EQ(1 + 2 + 4, int_stats.moves);
+
+  vector<element>::reset_stats();
+  EXPECT_EQ(vector_stats{}, vector<element>::stats());
+}
+
+TEST_F(correctness_test, parallel_copy) {
+  static constexpr size_t N = 10'000;
+  static constexpr parallel_policy policy{4, 100};
+
+  vector<std::string> a;
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(std::to_string(i));
+  }
+
+  vector<std::string> b(policy, a);
+  expect_eq(a, b);
+
+  vector<std::string> c;
+  c.push_back("x");
+  c.parallel_assign(policy, a);
+  expect_eq(a, c);
+
+  c.parallel_assign(policy, c);
+  expect_eq(a, c);
+
+  vector<std::string> d(parallel, vector<std::string>());
+  EXPECT_TRUE(d.empty());
+}
+
+TEST_F(correctness_test, parallel_fill_transform_find) {
+  static constexpr size_t N = 10'000;
+  static constexpr parallel_policy policy{4, 100};
+
+  vector<int> a;
+  a.parallel_fill(policy, N, 42);
+  ASSERT_EQ(N, a.size());
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(42, a[i]);
+  }
+
+  std::vector<int> values(N);
+  for (size_t i = 0; i < N; ++i) {
+    values[i] = i;
+  }
+  a.parallel_transform(policy, values.begin(), values.end(), [](int x) { return x % 1000; });
+  ASSERT_EQ(N, a.size());
+  for (size_t i = 0; i < N; ++i) {
+    ASSERT_EQ(i % 1000, a[i]);
+  }
+
+  EXPECT_EQ(a.begin() + 999, parallel_find(policy, a, 999));
+  EXPECT_EQ(a.begin(), parallel_find(policy, a, 0));
+  EXPECT_EQ(a.end(), parallel_find(policy, a, 1000));
+  const vector<int>& ca = a;
+  EXPECT_EQ(ca.begin() + 5, parallel_find(policy, ca, 5));
+}
+
+TEST_F(exception_safety_test, parallel_copy_throw) {
+  static constexpr size_t N = 1'000;
+  static constexpr parallel_policy policy{4, 10};
+
+  vector<counted_element> a;
+  for (size_t i = 0; i < N; ++i) {
+    a.emplace_back(i);
+  }
+
+  for (size_t k : {size_t(1), N / 2, N}) {
+    counted_element::copies_until_throw = k;
+    EXPECT_THROW(vector<counted_element>(policy, a), std::runtime_error);
+    EXPECT_EQ(N, counted_element::instances);
+
+    vector<counted_element> b;
+    b.emplace_back(-1);
+    counted_element::copies_until_throw = k;
+    EXPECT_THROW(b.parallel_assign(policy, a), std::runtime_error);
+    ASSERT_EQ(1, b.size());
+    EXPECT_EQ(-1, b[0].value);
+    EXPECT_EQ(N + 1, counted_element::instances);
+  }
+
+  counted_element::copies_until_throw = 0;
+}
+
+TEST_F(performance_test, parallel_copy) {
+  static constexpr size_t N = 50'000'000, K = 5;
+
+  vector<int> a;
+  a.parallel_fill(parallel, N, 1);
+  for (size_t i = 0; i < K; ++i) {
+    vector<int> b(parallel, a);
+    ASSERT_EQ(N, b.size());
+  }
+}
+
+TEST_F(correctness_test, from_raw) {
+  std::allocator<element> alloc;
+  element* data = alloc.allocate(10);
+  for (int i = 0; i < 3; ++i) {
+    new (data + i) element(i);
+  }
+
+  vector<element> a = vector<element>::from_raw({data, 3, 10});
+  EXPECT_EQ(data, a.data());
+  EXPECT_EQ(10, a.capacity());
+  a.push_back(3);
+  expect_eq(a, std::vector<int>{0, 1, 2, 3});
+
+  vector<element> b = vector<element>::from_raw({nullptr, 0, 0});
+  EXPECT_TRUE(b.empty());
+  b.push_back(1);
+}
+
+TEST_F(correctness_test, release) {
+  vector<element> a;
+  for (int i = 0; i < 5; ++i) {
+    a.push_back(i);
+  }
+  element* data = a.data();
+  size_t capacity = a.capacity();
+
+  element::reset_counters();
+  auto buffer = a.release();
+  EXPECT_EQ(data, buffer.data);
+  EXPECT_EQ(5, buffer.size);
+  EXPECT_EQ(capacity, buffer.capacity);
+  EXPECT_EQ(0, element::get_copy_counter());
+  EXPECT_EQ(0, element::get_move_counter());
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ(0, a.capacity());
+
+  vector<element> b = vector<element>::from_raw(buffer);
+  expect_eq(b, std::vector<int>{0, 1, 2, 3, 4});
+
+  auto empty = a.release();
+  EXPECT_EQ(nullptr, empty.data);
+}
+
+TEST_F(correctness_test, small_vector_release) {
+  small_vector<element, 4> a;
+  a.push_back(1);
+  a.push_back(2);
+
+  auto buffer = a.release();
+  EXPECT_TRUE(a.empty());
+  EXPECT_TRUE(is_stored_inline(a));
+  ASSERT_NE(nullptr, buffer.data);
+  EXPECT_EQ(2, buffer.size);
+
+  small_vector<element, 4> b = small_vector<element, 4>::from_raw(buffer);
+  EXPECT_FALSE(is_stored_inline(b));
+  expect_eq(b, std::vector<int>{1, 2});
+  b.shrink_to_fit();
+  b.push_back(3);
+  expect_eq(b, std::vector<int>{1, 2, 3});
+
+  small_vector<element, 4> c;
+  EXPECT_EQ(nullptr, c.release().data);
+}
+
+TEST_F(correctness_test, malloc_allocator_release) {
+  auto* data = static_cast<int*>(std::malloc(4 * sizeof(int)));
+  data[0] = 1;
+  data[1] = 2;
+
+  auto a = vector<int, malloc_allocator<int>>::from_raw({data, 2, 4});
+  a.push_back(3);
+  a.push_back(4);
+  a.push_back(5);
+  expect_eq(a, std::vector<int>{1, 2, 3, 4, 5});
+
+  auto buffer = a.release();
+  EXPECT_EQ(5, buffer.data[4]);
+  std::free(buffer.data);
+}
+
+TEST_F(correctness_test, small_vector_default_ctor) {
+  small_vector<element, 4> a;
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ(0, a.size());
+  EXPECT_EQ(4, a.capacity());
+  EXPECT_TRUE(is_stored_inline(a));
+}
+
+TEST_F(correctness_test, small_vector_push_back) {
+  static constexpr size_t N = 4, M = 500;
+
+  small_vector<element, N> a;
+  for (size_t i = 0; i < N; ++i) {
+    a.push_back(2 * i + 1);
+    ASSERT_TRUE(is_stored_inline(a));
+    ASSERT_EQ(N, a.capacity());
+  }
+
+  a.push_back(2 * N + 1);
+  EXPECT_FALSE(is_stored_inline(a));
+  EXPECT_EQ(2 * N, a.capacity());
+
+  for (size_t i = N + 1; i < M; ++i) {
+    a.push_back(2 * i + 1);
+  }
+  for (size_t i = 0; i < M; ++i) {
+    ASSERT_EQ(2 * i + 1, a[i]);
+  }
+}
+
+TEST_F(exception_safety_test, small_vector_push_back_throw) {
+  static constexpr size_t N = 10;
+
+  faulty_run([] {
+    small_vector<element, 4> a;
+    for (size_t i = 0; i < N; ++i) {
+      element x = 2 * i + 1;
+      strong_exception_safety_guard sg(a);
+      a.push_back(x);
+    }
+  });
+}
+
+TEST_F(correctness_test, small_vector_reserve) {
+  small_vector<element, 4> a;
+  a.reserve(3);
+  EXPECT_EQ(4, a.capacity());
+  EXPECT_TRUE(is_stored_inline(a));
+
+  a.push_back(1);
+  a.reserve(10);
+  EXPECT_EQ(10, a.capacity());
+  EXPECT_FALSE(is_stored_inline(a));
+  EXPECT_EQ(1, a[0]);
+}
+
+TEST_F(correctness_test, small_vector_shrink_to_fit) {
+  static constexpr size_t N = 4, M = 100;
+
+  small_vector<element, N> a;
+  for (size_t i = 0; i < M; ++i) {
+    a.push_back(2 * i + 1);
+  }
+
+  a.erase(a.begin() + 2, a.end());
+  a.shrink_to_fit();
+  EXPECT_TRUE(is_stored_inline(a));
+  EXPECT_EQ(N, a.capacity());
+  EXPECT_EQ(2, a.size());
+  EXPECT_EQ(1, a[0]);
+  EXPECT_EQ(3, a[1]);
+
+  a.shrink_to_fit();
+  EXPECT_TRUE(is_stored_inline(a));
+}
+
+TEST_F(correctness_test, small_vector_copy) {
+  small_vector<element, 4> a;
+  a.push_back(1);
+  a.push_back(2);
+
+  small_vector<element, 4> b = a;
+  EXPECT_TRUE(is_stored_inline(b));
+  expect_eq(a, b);
+
+  for (size_t i = 0; i < 10; ++i) {
+    a.push_back(i);
+  }
+  small_vector<element, 4> c = a;
+  EXPECT_FALSE(is_stored_inline(c));
+  EXPECT_EQ(a.size(), c.capacity());
+  expect_eq(a, c);
+
+  c = b;
+  expect_eq(b, c);
+  b = a;
+  expect_eq(a, b);
+}
+
+TEST_F(correctness_test, small_vector_move) {
+  small_vector<element, 4> a;
+  a.push_back(1);
+  a.push_back(2);
+
+  small_vector<element, 4> b = std::move(a);
+  EXPECT_TRUE(a.empty());
+  EXPECT_TRUE(is_stored_inline(b));
+  EXPECT_EQ(2, b.size());
+  EXPECT_EQ(1, b[0]);
+  EXPECT_EQ(2, b[1]);
+
+  small_vector<element, 4> c;
+  for (size_t i = 0; i < 10; ++i) {
+    c.push_back(i);
+  }
+  element* c_data = c.data();
+  b = std::move(c);
+  EXPECT_TRUE(c.empty());
+  EXPECT_TRUE(is_stored_inline(c));
+  EXPECT_EQ(4, c.capacity());
+  EXPECT_EQ(c_data, b.data());
+  EXPECT_EQ(10, b.size());
+
+  c.push_back(42);
+  b = std::move(c);
+  EXPECT_EQ(1, b.size());
+  EXPECT_EQ(42, b[0]);
+}
+
+TEST_F(exception_safety_test, small_vector_copy_assign_throw) {
+  static constexpr size_t N = 4;
+
+  for (size_t from_size : {2, 10}) {
+    for (size_t to_size : {1, 10}) {
+      faulty_run([from_size, to_size] {
+        fault_injection_disable dg;
+        small_vector<element, N> a;
+        for (size_t i = 0; i < from_size; ++i) {
+          a.push_back(2 * i + 1);
+        }
+        small_vector<element, N> b;
+        for (size_t i = 0; i < to_size; ++i) {
+          b.push_back(i);
+        }
+        dg.reset();
+
+        strong_exception_safety_guard sg_a(a);
+        strong_exception_safety_guard sg_b(b);
+        b = std::as_const(a);
+      });
+    }
+  }
+}
+
+TEST_F(exception_safety_test, small_vector_move_assign_throw) {
+  static constexpr size_t N = 4;
+
+  for (size_t from_size : {2, 10}) {
+    for (size_t to_size : {1, 10}) {
+      faulty_run([from_size, to_size] {
+        fault_injection_disable dg;
+        small_vector<element, N> a;
+        for (size_t i = 0; i < from_size; ++i) {
+          a.push_back(2 * i + 1);
+        }
+        small_vector<element, N> b;
+        for (size_t i = 0; i < to_size; ++i) {
+          b.push_back(i);
+        }
+        dg.reset();
+
+        strong_exception_safety_guard sg_a(a);
+        strong_exception_safety_guard sg_b(b);
+        b = std::move(a);
+      });
+    }
+  }
+}
+
+TEST_F(correctness_test, small_vector_swap) {
+  small_vector<element, 4> a;
+  a.push_back(1);
+  small_vector<element, 4> b;
+  for (size_t i = 0; i < 10; ++i) {
+    b.push_back(i);
+  }
+  element* b_data = b.data();
+
+  a.swap(b);
+  EXPECT_EQ(b_data, a.data());
+  EXPECT_EQ(10, a.size());
+  // `element` may throw on relocation, so the inline element is moved to the heap before swapping
+  EXPECT_FALSE(is_stored_inline(b));
+  EXPECT_EQ(1, b.size());
+  EXPECT_EQ(1, b[0]);
+
+  small_vector<element, 4> c;
+  c.push_back(5);
+  c.push_back(6);
+  swap(b, c);
+  EXPECT_EQ(2, b.size());
+  EXPECT_EQ(5, b[0]);
+  EXPECT_EQ(6, b[1]);
+  EXPECT_EQ(1, c.size());
+  EXPECT_EQ(1, c[0]);
+}
+
+TEST_F(correctness_test, small_vector_swap_nothrow_relocatable) {
+  small_vector<int, 4> a;
+  a.push_back(1);
+  small_vector<int, 4> b;
+  for (int i = 0; i < 5; ++i) {
+    b.push_back(i);
+  }
+  int* b_data = b.data();
+  a.swap(b);
+  EXPECT_EQ(b_data, a.data());
+  EXPECT_TRUE(is_stored_inline(b));
+  EXPECT_EQ(1, b.size());
+  EXPECT_EQ(1, b[0]);
+}
+
+TEST_F(exception_safety_test, small_vector_swap_throw) {
+  static constexpr size_t N = 4;
+
+  for (size_t a_size : {2, 10}) {
+    for (size_t b_size : {1, 10}) {
+      faulty_run([a_size, b_size] {
+        fault_injection_disable dg;
+        small_vector<element, N> a;
+        for (size_t i = 0; i < a_size; ++i) {
+          a.push_back(2 * i + 1);
+        }
+        small_vector<element, N> b;
+        for (size_t i = 0; i < b_size; ++i) {
+          b.push_back(i);
+        }
+        dg.reset();
+
+        strong_exception_safety_guard sg_a(a);
+        strong_exception_safety_guard sg_b(b);
+        a.swap(b);
+      });
+    }
+  }
+}
+
+TEST_F(correctness_test, small_vector_insert_erase) {
+  static constexpr size_t N = 100;
+
+  small_vector<element, 8> a;
+  vector<element> b;
+  for (size_t i = 0; i < N; ++i) {
+    a.insert(a.begin() + i / 2, element(i));
+    b.insert(b.begin() + i / 2, element(i));
+  }
+  expect_eq(b, a);
+
+  while (a.size() > 3) {
+    a.erase(a.begin() + 1);
+    b.erase(b.begin() + 1);
+  }
+  expect_eq(b, a);
+}
+
+TEST_F(correctness_test, small_vector_insert_range) {
+  small_vector<element, 8> a;
+  a.insert(a.end(), {1, 2, 6});
+  a.insert(a.begin() + 2, {3, 4, 5});
+  EXPECT_TRUE(is_stored_inline(a));
+  expect_eq(a, std::vector<int>{1, 2, 3, 4, 5, 6});
+
+  a.insert(a.begin(), 4, element(0));
+  EXPECT_FALSE(is_stored_inline(a));
+  expect_eq(a, std::vector<int>{0, 0, 0, 0, 1, 2, 3, 4, 5, 6});
+
+  a.assign({7, 8});
+  expect_eq(a, std::vector<int>{7, 8});
+}
+
+TEST_F(correctness_test, small_vector_destroy_order) {
+  small_vector<ordered_element, 2> a;
+  a.push_back(1);
+  a.push_back(2);
+  a.push_back(3);
+
+  small_vector<ordered_element, 2> b;
+  b.push_back(4);
+  b.push_back(5);
+}
+
+TEST_F(correctness_test, find_count_contains) {
+  vector<int> a;
+  for (int i = 0; i < 1000; ++i) {
+    a.push_back(i % 100);
+  }
+  EXPECT_EQ(a.begin() + 42, find(a, 42));
+  EXPECT_EQ(a.end(), find(a, 100));
+  EXPECT_EQ(std::as_const(a).begin() + 99, find(std::as_const(a), 99));
+  EXPECT_TRUE(contains(a, 0));
+  EXPECT_FALSE(contains(a, -1));
+  EXPECT_EQ(10, count(a, 7));
+  EXPECT_EQ(0, count(a, 1000));
+
+  vector<std::string> b;
+  b.push_back("a");
+  b.push_back("b");
+  b.push_back("a");
+  EXPECT_EQ(b.begin() + 1, find(b, "b"));
+  EXPECT_EQ(2, count(b, "a"));
+  EXPECT_FALSE(contains(b, "c"));
+}
+
+TEST_F(correctness_test, min_max_element) {
+  vector<int> a;
+  EXPECT_EQ(a.end(), min_element(a));
+  EXPECT_EQ(a.end(), max_element(a));
+  for (int i = 0; i < 1000; ++i) {
+    a.push_back((i * 37) % 1001 - 500);
+  }
+  EXPECT_EQ(std::min_element(a.begin(), a.end()), min_element(a));
+  EXPECT_EQ(std::max_element(a.begin(), a.end()), max_element(a));
+
+  vector<double> b;
+  b.push_back(2.5);
+  b.push_back(-1.5);
+  b.push_back(3.5);
+  EXPECT_EQ(-1.5, *min_element(std::as_const(b)));
+  EXPECT_EQ(3.5, *max_element(std::as_const(b)));
+}
+
+TEST_F(correctness_test, comparison) {
+  vector<int> a, b;
+  EXPECT_EQ(a, b);
+  for (int i = 0; i < 100; ++i) {
+    a.push_back(i);
+    b.push_back(i);
+  }
+  EXPECT_EQ(a, b);
+  EXPECT_TRUE(std::is_eq(a <=> b));
+
+  b.push_back(0);
+  EXPECT_NE(a, b);
+  EXPECT_LT(a, b);
+
+  b.pop_back();
+  b[70] = -1;
+  EXPECT_NE(a, b);
+  EXPECT_GT(a, b);
+
+  vector<std::string> c, d;
+  c.push_back("abc");
+  d.push_back("abd");
+  EXPECT_LT(c, d);
+  EXPECT_NE(c, d);
+  d[0] = "abc";
+  EXPECT_EQ(c, d);
+
+  vector<double> e, f;
+  e.push_back(std::numeric_limits<double>::quiet_NaN());
+  f.push_back(std::numeric_limits<double>::quiet_NaN());
+  EXPECT_NE(e, f);
+  EXPECT_EQ(std::partial_ordering::unordered, e <=> f);
+}
+
+namespace {
+
+constexpr vector<int> make_squares(int count) {
+  vector<int> result;
+  result.reserve(2);
+  for (int i = 0; i < count; ++i) {
+    result.push_back(i * i);
+  }
+  return result;
+}
+
+template <size_t N>
+consteval std::array<int, N> to_array(const vector<int>& v) {
+  std::array<int, N> result{};
+  std::copy(v.begin(), v.end(), result.begin());
+  return result;
+}
+
+consteval std::array<int, 9> make_table() {
+  vector<int> v = make_squares(6);
+  v.insert(v.begin() + 1, 42);
+  v.insert(v.end(), {7, 8});
+  v.erase(v.begin() + 3);
+  v.emplace(v.begin(), -1);
+  return to_array<9>(v);
+}
+
+constexpr bool nested_vectors() {
+  vector<vector<int>> v;
+  for (int i = 0; i < 50; ++i) {
+    v.push_back(make_squares(i));
+  }
+  v.insert(v.begin(), make_squares(3));
+  v.erase(v.begin() + 1, v.begin() + 10);
+  vector<vector<int>> copy = v;
+  copy.shrink_to_fit();
+  return copy == v && v.size() == 42 && v[0].size() == 3 && v[1].size() == 9 && v.back().back() == 48 * 48;
+}
+
+constexpr bool strings() {
+  vector<std::string> v;
+  v.resize(3, "abc");
+  v.resize(5);
+  v.insert(v.begin() + 1, std::string(40, 'x'));
+  v.pop_back();
+  vector<std::string> other;
+  other = std::move(v);
+  return other.size() == 5 && other[1].size() == 40 && other[4].empty() && v.empty();
+}
+
+constexpr bool search() {
+  vector<int> v = make_squares(10);
+  return *find(v, 49) == 49 && !contains(v, 50) && count(v, 0) == 1 && *max_element(v) == 81 &&
+         *min_element(v) == 0 && v < make_squares(11) && v == make_squares(10);
+}
+
+} // namespace
+
+TEST(constexpr_test, table) {
+  constexpr std::array<int, 9> table = make_table();
+  static_assert(table == std::array<int, 9>{-1, 0, 42, 1, 9, 16, 25, 7, 8});
+  vector<int> squares = make_squares(6);
+  EXPECT_TRUE(std::equal(squares.begin() + 3, squares.end(), table.begin() + 4));
+}
+
+TEST(constexpr_test, elements) {
+  static_assert(nested_vectors());
+  static_assert(strings());
+  static_assert(search());
+  EXPECT_TRUE(nested_vectors());
+  EXPECT_TRUE(strings());
+  EXPECT_TRUE(search());
 }
@@ -0,0 +1,85 @@
+#include "vector.h"
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <string>
+
+static_assert(std::contiguous_iterator<vector<int>::iterator>);
+static_assert(std::contiguous_iterator<vector<int>::const_iterator>);
+static_assert(std::ranges::contiguous_range<vector<std::string>>);
+
+// Checks must not cost anything when disabled
+static_assert(detail::checks_enabled || sizeof(vector<int>) == 3 * sizeof(void*));
+static_assert(detail::checks_enabled || std::is_same_v<vector<int>::iterator, int*>);
+
+TEST(vector_checks_test, valid_use) {
+  vector<int> a;
+  for (int i = 0; i < 10; ++i) {
+    a.push_back(i);
+  }
+  a.reserve(10);
+  vector<int>::const_iterator it = a.begin() + 3;
+  EXPECT_EQ(3, *it);
+  EXPECT_EQ(7, a.end() - it);
+  vector<int>::iterator next = a.erase(it);
+  EXPECT_EQ(a.begin() + 3, next);
+  EXPECT_EQ(4, *next);
+  a.insert(a.begin(), -1);
+  EXPECT_EQ(-1, a.front());
+  EXPECT_EQ(9, a.back());
+  a.pop_back();
+  EXPECT_EQ(9, a.size());
+}
+
+#ifdef VECTOR_CHECKED
+
+TEST(vector_checks_death_test, element_access) {
+  vector<int> a;
+  EXPECT_DEATH(a.front(), "front\\(\\) of an empty vector");
+  EXPECT_DEATH(a.back(), "back\\(\\) of an empty vector");
+  EXPECT_DEATH(a.pop_back(), "pop_back\\(\\) of an empty vector");
+  a.push_back(1);
+  EXPECT_DEATH(a[1], "index out of range");
+  EXPECT_EQ(1, a[0]);
+  a.shrink_to_fit();
+  EXPECT_DEATH(a.unchecked_push_back(2), "unchecked_emplace_back\\(\\) of a full vector");
+}
+
+TEST(vector_checks_death_test, invalidated_iterator) {
+  vector<int> a;
+  a.push_back(1);
+  vector<int>::iterator it = a.begin();
+  a.reserve(100);
+  EXPECT_DEATH(*it, "invalidated by reallocation");
+  it = a.begin();
+  EXPECT_EQ(1, *it);
+  for (int i = 0; i < 200; ++i) {
+    a.push_back(i);
+  }
+  EXPECT_DEATH(a.erase(it), "invalidated by reallocation");
+}
+
+TEST(vector_checks_death_test, out_of_range_iterator) {
+  vector<int> a, b;
+  a.push_back(1);
+  EXPECT_DEATH(*a.end(), "dereferencing the end iterator");
+  EXPECT_DEATH(a.end() + 1, "iterator moved out of range");
+  EXPECT_DEATH(a.begin() - 1, "iterator moved out of range");
+  EXPECT_DEATH(b.insert(a.begin(), 0), "iterator of another vector");
+  EXPECT_DEATH(static_cast<void>(a.begin() == b.begin()), "iterators of different vectors");
+}
+
+TEST(vector_checks_death_test, invalid_erase_range) {
+  vector<int> a;
+  for (int i = 0; i < 5; ++i) {
+    a.push_back(i);
+  }
+  vector<int>::const_iterator first = a.begin() + 3;
+  vector<int>::const_iterator last = a.begin() + 1;
+  EXPECT_DEATH(a.erase(first, last), "erasing an invalid range");
+  EXPECT_EQ(a.begin() + 1, a.erase(last, first));
+  EXPECT_EQ(3, a.size());
+}
+
+#endif
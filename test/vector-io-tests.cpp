@@ -0,0 +1,215 @@
+#include "vector-io.h"
+#include "vector.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+namespace {
+
+struct point {
+  int32_t x;
+  int32_t y;
+
+  friend bool operator==(const point&, const point&) = default;
+};
+
+// Stream buffer that can't seek, like a pipe, so the reader can't know the length of the input
+class unseekable_buf : public std::stringbuf {
+public:
+  explicit unseekable_buf(const std::string& bytes)
+      : std::stringbuf(bytes) {}
+
+protected:
+  pos_type seekoff(off_type, std::ios_base::seekdir, std::ios_base::openmode) override {
+    return pos_type(off_type(-1));
+  }
+
+  pos_type seekpos(pos_type, std::ios_base::openmode) override {
+    return pos_type(off_type(-1));
+  }
+};
+
+template <typename T>
+vector<T> make_vector(size_t size) {
+  vector<T> result;
+  for (size_t i = 0; i < size; ++i) {
+    result.push_back(static_cast<T>(i * 3 + 1));
+  }
+  return result;
+}
+
+// Serialized `make_vector<int>(size)` with the size in the header replaced by `claimed_size`
+std::string with_claimed_size(size_t size, uint64_t claimed_size) {
+  std::stringstream stream;
+  write_to(stream, make_vector<int>(size));
+  std::string bytes = stream.str();
+  std::memcpy(bytes.data() + 16, &claimed_size, sizeof(claimed_size));
+  return bytes;
+}
+
+} // namespace
+
+TEST(vector_io_test, stream_round_trip) {
+  static constexpr size_t N = 100'000;
+
+  vector<int> a = make_vector<int>(N);
+  vector<double> b = make_vector<double>(17);
+  vector<point> c;
+  c.push_back({1, 2});
+  c.push_back({3, 4});
+
+  std::stringstream stream;
+  write_to(stream, a);
+  write_to(stream, b);
+  write_to(stream, c);
+  write_to(stream, vector<int>());
+  EXPECT_EQ(4 * 24 + N * sizeof(int) + 17 * sizeof(double) + 2 * sizeof(point), stream.str().size());
+
+  vector<int> a2;
+  a2.push_back(42);
+  vector<double> b2;
+  small_vector<point, 4> c2;
+  vector<int> d2 = make_vector<int>(3);
+  ASSERT_TRUE(read_from(stream, a2));
+  ASSERT_TRUE(read_from(stream, b2));
+  ASSERT_TRUE(read_from(stream, c2));
+  ASSERT_TRUE(read_from(stream, d2));
+  EXPECT_TRUE(std::equal(a.begin(), a.end(), a2.begin(), a2.end()));
+  EXPECT_TRUE(std::equal(b.begin(), b.end(), b2.begin(), b2.end()));
+  EXPECT_TRUE(std::equal(c.begin(), c.end(), c2.begin(), c2.end()));
+  EXPECT_TRUE(d2.empty());
+
+  EXPECT_FALSE(read_from(stream, a2));
+}
+
+TEST(vector_io_test, stream_errors) {
+  std::stringstream stream;
+  write_to(stream, make_vector<int>(10));
+  std::string bytes = stream.str();
+
+  std::istringstream truncated(bytes.substr(0, bytes.size() - 1));
+  vector<int> a = make_vector<int>(3);
+  EXPECT_FALSE(read_from(truncated, a));
+  EXPECT_TRUE(a.empty());
+
+  std::istringstream wrong_type(bytes);
+  vector<int64_t> b;
+  EXPECT_FALSE(read_from(wrong_type, b));
+  EXPECT_TRUE(b.empty());
+
+  std::istringstream garbage(std::string(100, 'x'));
+  EXPECT_FALSE(read_from(garbage, a));
+}
+
+TEST(vector_io_test, corrupt_size) {
+  static constexpr uint64_t huge = uint64_t(1) << 60;
+
+  std::istringstream seekable(with_claimed_size(10, huge));
+  vector<int> a;
+  EXPECT_FALSE(read_from(seekable, a));
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ(0, a.capacity());
+
+  unseekable_buf buf(with_claimed_size(10, huge));
+  std::istream unseekable(&buf);
+  EXPECT_FALSE(read_from(unseekable, a));
+  EXPECT_TRUE(a.empty());
+
+  std::istringstream overflowing(with_claimed_size(10, UINT64_MAX / 2));
+  EXPECT_FALSE(read_from(overflowing, a));
+}
+
+TEST(vector_io_test, unseekable_stream) {
+  static constexpr size_t N = 1'000'000;
+
+  std::stringstream stream;
+  vector<int> a = make_vector<int>(N);
+  write_to(stream, a);
+  write_to(stream, make_vector<int>(5));
+  unseekable_buf buf(stream.str());
+  std::istream in(&buf);
+
+  vector<int> b;
+  ASSERT_TRUE(read_from(in, b));
+  EXPECT_TRUE(std::equal(a.begin(), a.end(), b.begin(), b.end()));
+  ASSERT_TRUE(read_from(in, b));
+  EXPECT_EQ(5, b.size());
+  EXPECT_FALSE(read_from(in, b));
+}
+
+TEST(vector_io_test, swapped_byte_order) {
+  std::stringstream stream;
+  write_to(stream, make_vector<uint32_t>(3));
+  std::string bytes = stream.str();
+
+  // Reverses every 4-byte word of the header and the elements, and the 8-byte size
+  auto reverse = [&](size_t offset, size_t length) {
+    std::reverse(bytes.begin() + offset, bytes.begin() + offset + length);
+  };
+  for (size_t offset : {0, 4, 8, 12}) {
+    reverse(offset, 4);
+  }
+  reverse(16, 8);
+  for (size_t i = 0; i < 3; ++i) {
+    reverse(24 + 4 * i, 4);
+  }
+
+  std::istringstream in(bytes);
+  vector<uint32_t> a;
+  ASSERT_TRUE(read_from(in, a));
+  ASSERT_EQ(3, a.size());
+  EXPECT_EQ(1, a[0]);
+  EXPECT_EQ(4, a[1]);
+  EXPECT_EQ(7, a[2]);
+
+  std::istringstream in_struct(bytes);
+  vector<point> b;
+  EXPECT_FALSE(read_from(in_struct, b));
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+TEST(vector_io_test, fd_round_trip) {
+  static constexpr size_t N = 1'000'000;
+
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(nullptr, file);
+  int fd = fileno(file);
+
+  vector<int> a = make_vector<int>(N);
+  write_to(fd, a);
+  write_to(fd, make_vector<int>(5));
+  ASSERT_EQ(0, ::lseek(fd, 0, SEEK_SET));
+
+  vector<int> b;
+  ASSERT_TRUE(read_from(fd, b));
+  EXPECT_TRUE(std::equal(a.begin(), a.end(), b.begin(), b.end()));
+  ASSERT_TRUE(read_from(fd, b));
+  EXPECT_EQ(5, b.size());
+  EXPECT_FALSE(read_from(fd, b));
+
+  ASSERT_EQ(0, ::ftruncate(fd, 24 + 4));
+  ASSERT_EQ(0, ::lseek(fd, 0, SEEK_SET));
+  EXPECT_THROW(read_from(fd, b), std::system_error);
+  EXPECT_TRUE(b.empty());
+
+  std::fclose(file);
+
+  int pipe_fds[2];
+  ASSERT_EQ(0, ::pipe(pipe_fds));
+  std::string corrupt = with_claimed_size(10, uint64_t(1) << 60);
+  ASSERT_EQ(corrupt.size(), ::write(pipe_fds[1], corrupt.data(), corrupt.size()));
+  ::close(pipe_fds[1]);
+  EXPECT_THROW(read_from(pipe_fds[0], b), std::system_error);
+  EXPECT_TRUE(b.empty());
+  ::close(pipe_fds[0]);
+}
+
+#endif